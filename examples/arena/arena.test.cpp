@@ -0,0 +1,162 @@
+#include <foundry_runtime/arena/arena.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+constexpr std::size_t messages_per_batch = 64;
+
+struct Message {
+    std::uint32_t length;
+    std::uint32_t checksum;
+
+    // length bytes follow the header
+    std::uint8_t*       bytes() { return reinterpret_cast<std::uint8_t*>(this + 1); }
+    const std::uint8_t* bytes() const { return reinterpret_cast<const std::uint8_t*>(this + 1); }
+};
+
+// trivially copyable, so it can go through the spsc_queue, the chunks travel as a raw pointer
+struct BatchDescriptor {
+    foundry_runtime::arena_chunk* chunks;
+    Message**                     messages;
+    std::uint64_t                 batch_id;
+};
+
+using ArenaType = foundry_runtime::arena<>;
+using QueueType = foundry_runtime::spsc_queue<BatchDescriptor, 64, true, false>;
+
+std::uint32_t lengthOf(std::uint64_t batch_id, std::size_t i) { return std::uint32_t(16 + (batch_id * 31 + i * 17) % 400); }
+
+void fill(Message* message, std::uint32_t length, std::uint64_t seed) {
+    message->length   = length;
+    message->checksum = 0;
+    for (std::uint32_t b = 0; b < length; ++b) {
+        message->bytes()[b] = std::uint8_t(seed + b);
+        message->checksum += message->bytes()[b];
+    }
+}
+
+bool valid(const Message* message) {
+    std::uint32_t checksum = 0;
+    for (std::uint32_t b = 0; b < message->length; ++b) checksum += message->bytes()[b];
+    return checksum == message->checksum;
+}
+
+struct ArenaPayloads {
+    static constexpr const char* name = "arena";
+    ArenaType arena;
+
+    Message** make_batch(std::uint64_t) { return arena.make_array<Message*>(messages_per_batch); }
+    Message*  make_message(std::uint32_t length) { return static_cast<Message*>(arena.allocate(sizeof(Message) + length, alignof(Message))); }
+    foundry_runtime::arena_chunk* seal() { return arena.detach().release(); }
+
+    // downstream
+    void free_batch(const BatchDescriptor& batch) { arena.recycle(foundry_runtime::arena_batch(batch.chunks)); }
+    std::size_t chunk_allocations() const { return arena.chunks_allocated(); }
+};
+
+// the hot path this replaces: one malloc per payload, one free per payload downstream
+struct MallocPayloads {
+    static constexpr const char* name = "malloc";
+
+    Message** make_batch(std::uint64_t) { return static_cast<Message**>(std::malloc(sizeof(Message*) * messages_per_batch)); }
+    Message*  make_message(std::uint32_t length) { return static_cast<Message*>(std::malloc(sizeof(Message) + length)); }
+    foundry_runtime::arena_chunk* seal() { return nullptr; }
+
+    void free_batch(const BatchDescriptor& batch) {
+        for (std::size_t i = 0; i < messages_per_batch; ++i) std::free(batch.messages[i]);
+        std::free(batch.messages);
+    }
+    std::size_t chunk_allocations() const { return 0; }
+};
+
+/*
+Batch Pipeline:
+    - the upstream stage builds batches of messages_per_batch variable length messages and sends one descriptor per batch
+    - the downstream stage checks every checksum, then frees the whole batch (arena: hands the chunks back via recycle())
+*/
+template <class Payloads>
+bool runPipeline(std::uint64_t batches) {
+    auto payloads = std::make_unique<Payloads>();
+    auto queue    = std::make_unique<QueueType>();
+    std::uint64_t errors = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread downstream([&] {
+        BatchDescriptor batch;
+        for (std::uint64_t expected = 0; expected < batches; ++expected) {
+            while (!queue->try_dequeue(batch)) std::this_thread::yield();
+
+            errors += batch.batch_id != expected;
+            for (std::size_t i = 0; i < messages_per_batch; ++i) {
+                errors += !valid(batch.messages[i]) || batch.messages[i]->length != lengthOf(expected, i);
+            }
+            payloads->free_batch(batch);
+        }
+    });
+
+    for (std::uint64_t batch_id = 0; batch_id < batches; ++batch_id) {
+        Message** messages = payloads->make_batch(batch_id);
+        for (std::size_t i = 0; i < messages_per_batch; ++i) {
+            const std::uint32_t length = lengthOf(batch_id, i);
+            messages[i] = payloads->make_message(length);
+            fill(messages[i], length, batch_id + i);
+        }
+
+        const BatchDescriptor batch{payloads->seal(), messages, batch_id};
+        while (!queue->try_enqueue(batch)) std::this_thread::yield();
+    }
+    downstream.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "payloads=" << Payloads::name << " batches=" << batches << " errors=" << errors
+              << " chunk_allocations=" << payloads->chunk_allocations()
+              << " time=" << std::chrono::duration<double>(end - start).count() << "\n";
+    return errors == 0;
+}
+
+/*
+Over Aligned At Chunk End:
+    - fills a chunk to one byte short of its end, then asks for more alignment than the chunk's end address has
+      (twice its lowest set bit, so aligning the cursor up always lands past the end, wherever the chunk was placed)
+    - that has to start a new chunk rather than hand out memory outside the old one
+*/
+bool runOverAlignedAtChunkEnd() {
+    using SmallArena = foundry_runtime::arena<1024>;
+    constexpr std::size_t payload = 1024 - sizeof(foundry_runtime::arena_chunk);
+
+    auto arena = std::make_unique<SmallArena>();
+    const auto chunk_end = reinterpret_cast<std::uintptr_t>(arena->allocate(payload - 1, 1)) + payload;
+    const std::size_t chunks_before = arena->chunks_allocated();
+
+    const std::size_t align = std::size_t(chunk_end & (~chunk_end + 1)) * 2;
+    auto* slot = static_cast<std::uint64_t*>(arena->allocate(256, align));
+    slot[31] = 42;
+
+    const auto address   = reinterpret_cast<std::uintptr_t>(slot);
+    const bool aligned   = address % align == 0;
+    const bool new_chunk = arena->chunks_allocated() == chunks_before + 1;
+
+    std::cout << "over_aligned align=" << align << " aligned=" << aligned << " new_chunk=" << new_chunk << "\n";
+    return aligned && new_chunk;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t batches = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+
+    const bool malloc_ok = runPipeline<MallocPayloads>(batches);
+    const bool arena_ok  = runPipeline<ArenaPayloads>(batches);
+
+    const bool aligned_ok = runOverAlignedAtChunkEnd();
+
+    return (malloc_ok && arena_ok && aligned_ok) ? 0 : 1;
+}
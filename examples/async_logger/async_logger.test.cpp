@@ -0,0 +1,71 @@
+#include <foundry_runtime/async_logger/async_logger.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+
+enum class Side : std::uint8_t { Buy, Sell };
+
+/*
+Async Logger:
+    - num_threads hot threads each log number records through their own producer
+    - each thread times its own bursts of log calls with the tsc, that is the only cost the hot path sees
+    - output goes to a file so the background formatting + writev is really exercised
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t number      = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t   num_threads = 2;
+    const char*         out_path    = "async_logger.test.log";
+
+    const int fd = ::open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "could not open " << out_path << "\n";
+        return 1;
+    }
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate();
+
+    std::vector<double>        ns_per_log(num_threads);
+    std::vector<std::uint64_t> dropped(num_threads);
+    {
+        foundry_runtime::async_logger<> logger(fd);
+
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t] {
+                auto& producer = logger.create_producer();
+
+                // only the bursts of log calls are timed, the yields between bursts let the background thread catch up
+                std::uint64_t log_ticks = 0;
+                for (std::uint64_t burst = 0; burst < number; burst += 1024) {
+                    const std::uint64_t start = foundry_runtime::read_tsc();
+                    for (std::uint64_t i = burst; i < burst + 1024 && i < number; ++i) {
+                        FOUNDRY_LOG(producer, "thread={} order={} side={} px={} qty={} venue={}", t, i, Side(i & 1), 100.25 + double(i % 7), std::uint32_t(i % 500), "XNAS");
+                    }
+                    log_ticks += foundry_runtime::read_tsc() - start;
+                    std::this_thread::yield();
+                }
+                ns_per_log[t] = clock.to_ns(log_ticks) / double(number);
+                dropped[t]    = producer.dropped_count();
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+    ::close(fd);
+
+    for (std::size_t t = 0; t < num_threads; ++t) {
+        std::cout << "Thread=" << t << " ns/log=" << ns_per_log[t] << " Dropped=" << dropped[t] << "\n";
+    }
+    std::cout << "Output=" << out_path << "\n";
+
+    std::remove(out_path);
+
+    return 0;
+}
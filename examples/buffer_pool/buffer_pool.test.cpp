@@ -0,0 +1,84 @@
+#include <foundry_runtime/buffer_pool/buffer_pool.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+constexpr std::size_t payload_size = 4000; // deliberately not a multiple of the cacheline, stride rounds it up
+constexpr std::size_t pool_buffers = 256;
+
+using PoolType  = foundry_runtime::buffer_pool<payload_size, pool_buffers>;
+using QueueType = foundry_runtime::spsc_queue<std::byte*, 128, true, false>;
+
+/*
+Payload Round Trip:
+    - the producer acquires a buffer, stamps a sequence number into the first and last words, sends the pointer
+    - the consumer checks both stamps and the pool ownership, then releases it back (batched return path)
+    - more messages than buffers, so every buffer goes round many times, with no malloc/free after startup
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t number         = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const bool          try_huge_pages = argc > 2 && std::strcmp(argv[2], "huge") == 0;
+
+    auto pool    = std::make_unique<PoolType>(try_huge_pages);
+    auto forward = std::make_unique<QueueType>();
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread consumer([&] {
+        std::byte* buffer;
+        std::uint64_t expected = 0, errors = 0;
+        while (expected < number) {
+            if (!forward->try_dequeue(buffer)) {
+                pool->flush_returns(); // about to wait, don't keep buffers parked in staging
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::uint64_t head, tail;
+            std::memcpy(&head, buffer, sizeof(head));
+            std::memcpy(&tail, buffer + payload_size - sizeof(tail), sizeof(tail));
+            errors += head != expected || tail != expected || !pool->owns(buffer);
+            expected++;
+
+            pool->release(buffer);
+        }
+        pool->flush_returns();
+        if (errors) std::cout << "Consumer Errors=" << errors << "\n";
+    });
+
+    std::uint64_t pool_empty_waits = 0;
+    for (std::uint64_t i = 0; i < number; ++i) {
+        std::byte* buffer;
+        while ((buffer = pool->acquire()) == nullptr) {
+            pool_empty_waits++;
+            std::this_thread::yield();
+        }
+
+        std::memcpy(buffer, &i, sizeof(i));
+        std::memcpy(buffer + payload_size - sizeof(i), &i, sizeof(i));
+
+        while (!forward->try_enqueue(buffer)) std::this_thread::yield();
+    }
+    consumer.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    // everything came back, so the whole pool has to be acquirable again
+    std::size_t recovered = 0;
+    while (pool->acquire() != nullptr) recovered++;
+
+    std::cout << "Payload=" << payload_size << " Stride=" << PoolType::stride << " Buffers=" << PoolType::size()
+              << " Huge Pages=" << pool->huge_pages() << "\n";
+    std::cout << "Messages=" << number << " Pool Empty Waits=" << pool_empty_waits << " Recovered=" << recovered << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    return recovered == pool_buffers ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <foundry_runtime/conflating_channel/conflating_channel.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+
+
+// every field carries the same value, so a torn read shows up as a snapshot that disagrees with itself
+struct MarketSnapshot {
+    std::uint64_t fields[16];
+};
+
+template <class ChannelType>
+int runConflation(const char* config_name, std::uint64_t number) {
+    ChannelType channel;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        MarketSnapshot snapshot;
+        for (std::uint64_t i = 1; i <= number; ++i) {
+            for (auto& field : snapshot.fields) field = i;
+            channel.publish(snapshot);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::uint64_t reads = 0, torn = 0, out_of_order = 0, last_version = 0;
+    MarketSnapshot snapshot;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!done.load(std::memory_order_acquire) || channel.latest_version() > last_version) {
+        const std::uint64_t previous_version = last_version;
+        if (!channel.read_if_newer(snapshot, last_version)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        reads++;
+        for (const auto field : snapshot.fields) torn += field != snapshot.fields[0];
+        out_of_order += snapshot.fields[0] <= previous_version;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    producer.join();
+
+    std::cout << "config=" << config_name
+              << " published=" << number
+              << " reads=" << reads
+              << " conflated=" << (number - reads)
+              << " torn=" << torn
+              << " out_of_order=" << out_of_order
+              << " last_version=" << last_version
+              << " time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    return (torn == 0 && out_of_order == 0 && last_version == number) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+
+    int failures = 0;
+    failures += runConflation<foundry_runtime::conflating_channel<MarketSnapshot, 1>>("single_slot", number);
+    failures += runConflation<foundry_runtime::conflating_channel<MarketSnapshot, 4>>("four_slots",  number);
+
+    return failures;
+}
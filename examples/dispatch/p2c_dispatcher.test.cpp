@@ -0,0 +1,148 @@
+#include <foundry_runtime/dispatch/p2c_dispatcher.h>
+#include <foundry_runtime/hdr_histogram/hdr_histogram.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+
+constexpr std::size_t num_workers = 4;
+
+struct Job {
+    std::uint64_t dispatch_tsc;
+    std::uint32_t service_ns;
+    std::uint32_t id;
+};
+
+using Dispatcher = foundry_runtime::p2c_dispatcher<Job, num_workers, 256>;
+
+struct PowerOfTwo {
+    static constexpr const char* name = "p2c";
+    bool operator()(Dispatcher& dispatcher, const Job& job) { return dispatcher.dispatch(job); }
+};
+
+// same queues, the producer just walks them in order
+struct RoundRobin {
+    static constexpr const char* name = "round_robin";
+    std::size_t next = 0;
+    bool operator()(Dispatcher& dispatcher, const Job& job) {
+        if (!dispatcher.worker_queue(next).try_enqueue(job)) return false;
+        next = (next + 1) % num_workers;
+        return true;
+    }
+};
+
+void spinFor(std::uint64_t ticks) {
+    const std::uint64_t start = foundry_runtime::read_tsc();
+    while (foundry_runtime::read_tsc() - start < ticks) foundry_runtime::cpu_relax();
+}
+
+/*
+Skewed Service:
+    - worker 0 is a noisy neighbour and runs every job 4x slower than the others
+    - 1 in 32 jobs is a heavy one and costs 20x the base service time wherever it lands
+    - the producer paces arrivals, each job carries its dispatch tsc and the worker records dispatch -> done
+    - round robin keeps feeding the slow worker its full share, p2c steers away from whichever queues are backed up
+*/
+template <class Strategy>
+void runSkewed(std::uint64_t jobs, const foundry_runtime::tsc_clock& clock) {
+    auto dispatcher = std::make_unique<Dispatcher>();
+    std::atomic<bool> done{false};
+    std::vector<foundry_runtime::hdr_histogram<>> latency_ns(num_workers);
+    std::vector<std::uint64_t> handled(num_workers, 0);
+
+    std::vector<std::thread> workers;
+    for (std::size_t worker = 0; worker < num_workers; ++worker) {
+        workers.emplace_back([&, worker] {
+            const std::uint64_t slowdown = worker == 0 ? 4 : 1;
+            Job job;
+            for (;;) {
+                const bool finished = done.load(std::memory_order_acquire);
+                if (!dispatcher->worker_queue(worker).try_dequeue(job)) {
+                    if (finished) break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                spinFor(clock.ns_to_ticks(job.service_ns * slowdown));
+
+                latency_ns[worker].record(std::uint64_t(clock.to_ns(foundry_runtime::read_tsc() - job.dispatch_tsc)));
+                handled[worker]++;
+            }
+        });
+    }
+
+    Strategy strategy;
+    const std::uint64_t gap_ticks = std::uint64_t(2'000 * clock.ticks_per_ns());
+    std::uint64_t backpressured = 0;
+
+    for (std::uint64_t i = 0; i < jobs; ++i) {
+        const std::uint32_t service_ns = (i % 32 == 31) ? 20'000 : 1'000;
+        const Job job{foundry_runtime::read_tsc(), service_ns, std::uint32_t(i)};
+
+        while (!strategy(*dispatcher, job)) {
+            backpressured++;
+            std::this_thread::yield();
+        }
+        spinFor(gap_ticks);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& worker : workers) worker.join();
+
+    foundry_runtime::hdr_histogram<> all_ns;
+    for (const auto& histogram : latency_ns) all_ns.merge(histogram);
+
+    std::cout << "strategy=" << Strategy::name << " jobs=" << all_ns.count() << " backpressured=" << backpressured << "\n";
+    std::cout << "    latency_ns p50=" << all_ns.value_at_percentile(50.0)
+              << " p99="   << all_ns.value_at_percentile(99.0)
+              << " p99.9=" << all_ns.value_at_percentile(99.9)
+              << " max="   << all_ns.max() << "\n";
+    std::cout << "    handled";
+    for (std::size_t worker = 0; worker < num_workers; ++worker) std::cout << " w" << worker << "=" << handled[worker];
+    std::cout << "\n";
+}
+
+/*
+Backed Up Worker:
+    - no workers running, worker 0's queue is preloaded with 200 jobs (as if it had stalled)
+    - 300 more dispatches split over the other three never reach 100 each, so p2c must never pick worker 0
+*/
+bool backedUpWorkerIsAvoided() {
+    auto dispatcher = std::make_unique<Dispatcher>();
+    for (std::uint32_t i = 0; i < 200; ++i) dispatcher->worker_queue(0).try_enqueue(Job{0, 0, i});
+
+    std::uint64_t sent_to_stalled = 0;
+    for (std::uint32_t i = 0; i < 300; ++i) {
+        if (!dispatcher->dispatch(Job{0, 0, i})) return false;
+        sent_to_stalled += dispatcher->last_worker() == 0;
+    }
+
+    std::cout << "Backed Up Worker Dispatches=" << sent_to_stalled << " Queued";
+    for (std::size_t worker = 0; worker < num_workers; ++worker) std::cout << " w" << worker << "=" << dispatcher->queued(worker);
+    std::cout << "\n";
+    return sent_to_stalled == 0;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t jobs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate();
+    std::cout << "tsc ticks/ns=" << clock.ticks_per_ns() << "\n";
+
+    // with a single hardware thread the workers and the producer share one core, the percentiles are mostly time slices
+    if (std::thread::hardware_concurrency() <= num_workers) {
+        std::cout << "note: only " << std::thread::hardware_concurrency() << " hardware threads for " << num_workers + 1 << " threads\n";
+    }
+
+    const bool avoided = backedUpWorkerIsAvoided();
+
+    runSkewed<RoundRobin>(jobs, clock);
+    runSkewed<PowerOfTwo>(jobs, clock);
+
+    return avoided ? 0 : 1;
+}
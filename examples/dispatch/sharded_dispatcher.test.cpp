@@ -0,0 +1,103 @@
+#include <foundry_runtime/dispatch/sharded_dispatcher.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+
+constexpr std::size_t num_shards  = 4;
+constexpr std::size_t num_symbols = 64;
+
+struct BookUpdate {
+    std::uint32_t symbol_id;
+    std::uint32_t sequence; // per symbol, so the worker can check per key ordering
+    std::int64_t  px;
+    std::int64_t  qty;
+};
+
+struct SymbolKey {
+    std::uint32_t operator()(const BookUpdate& update) const noexcept { return update.symbol_id; }
+};
+
+using Dispatcher = foundry_runtime::sharded_dispatcher<BookUpdate, num_shards, SymbolKey>;
+
+/*
+Partitioned Book:
+    - one feed thread dispatches updates for num_symbols symbols round robin
+    - every worker checks each symbol it sees is always on its shard and its sequence numbers arrive in order
+    - worker 0 is deliberately slow, so its shard backs up while the other shards keep draining
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+
+    auto dispatcher = std::make_unique<Dispatcher>();
+    std::atomic<bool> feed_done{false};
+    std::vector<std::uint64_t> errors(num_shards, 0), handled(num_shards, 0);
+
+    std::vector<std::thread> workers;
+    for (std::size_t shard = 0; shard < num_shards; ++shard) {
+        workers.emplace_back([&, shard] {
+            std::vector<std::uint32_t> next_sequence(num_symbols, 0);
+            BookUpdate batch[32];
+
+            for (;;) {
+                const bool done = feed_done.load(std::memory_order_acquire);
+                const std::size_t count = dispatcher->shard_queue(shard).try_dequeue_bulk(batch, 32);
+                if (count == 0) {
+                    if (done) break;
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    const BookUpdate& update = batch[i];
+                    errors[shard] += dispatcher->shard_of(update) != shard;
+                    errors[shard] += update.sequence != next_sequence[update.symbol_id];
+                    next_sequence[update.symbol_id] = update.sequence + 1;
+                }
+                handled[shard] += count;
+
+                if (shard == 0) std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::uint32_t> sequences(num_symbols, 0);
+    std::uint64_t backpressured = 0, max_occupancy_shard0 = 0;
+    for (std::uint64_t i = 0; i < number; ++i) {
+        const auto symbol = std::uint32_t(i % num_symbols);
+        const BookUpdate update{symbol, sequences[symbol], std::int64_t(10'000 + i % 100), std::int64_t(i % 10 + 1)};
+
+        while (!dispatcher->dispatch(update)) {
+            backpressured++;
+            std::this_thread::yield();
+        }
+        sequences[symbol]++;
+
+        if ((i & 1023) == 0 && dispatcher->occupancy(0) > max_occupancy_shard0) max_occupancy_shard0 = dispatcher->occupancy(0);
+    }
+    while (dispatcher->flush() > 0) std::this_thread::yield();
+    feed_done.store(true, std::memory_order_release);
+
+    for (auto& worker : workers) worker.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::uint64_t total_handled = 0, total_errors = 0;
+    for (std::size_t shard = 0; shard < num_shards; ++shard) {
+        std::cout << "Shard=" << shard << " Handled=" << handled[shard] << " Errors=" << errors[shard] << "\n";
+        total_handled += handled[shard];
+        total_errors  += errors[shard];
+    }
+    std::cout << "Backpressured Dispatches=" << backpressured << " Max Shard0 Occupancy=" << max_occupancy_shard0 << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    return (total_handled == number && total_errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include <foundry_runtime/inline_function/inline_function.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+
+
+using Task      = foundry_runtime::inline_function<void()>;
+using TaskQueue = foundry_runtime::spsc_queue<Task, 1024, true, false>;
+
+struct Order {
+    std::uint64_t id;
+    std::uint32_t qty;
+    double        px;
+};
+
+/*
+Task Shipping:
+    - the producer ships number lambdas (each capturing an Order by value and a pointer to the worker's state)
+    - the worker runs whatever shows up, so all of the state mutation happens on the worker thread
+    - nothing allocates, the lambda is built into a temporary inline_function on the stack and copied into the ring slot
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+
+    TaskQueue queue;
+    std::uint64_t worker_qty = 0; // only ever touched by tasks, i.e. only by the worker thread
+    std::uint64_t expected_qty = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread worker([&queue, number] {
+        std::uint64_t ran = 0;
+        while (ran < number) {
+            const std::size_t batch = foundry_runtime::run_tasks(queue, 64);
+            if (batch == 0) std::this_thread::yield();
+            ran += batch;
+        }
+    });
+
+    for (std::uint64_t i = 0; i < number; ++i) {
+        const Order order{i, std::uint32_t(i % 100), 100.0};
+        expected_qty += order.qty;
+
+        std::uint64_t* total = &worker_qty;
+        while (!foundry_runtime::submit_to(queue, [order, total] { *total += order.qty; })) {
+            std::this_thread::yield();
+        }
+    }
+    worker.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Num Tasks=" << number << "\n";
+    std::cout << "Sizeof Task=" << sizeof(Task) << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+    std::cout << "Worker Qty=" << worker_qty << " Expected Qty=" << expected_qty << "\n";
+
+    return worker_qty == expected_qty ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <foundry_runtime/merge/timestamp_merger.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+
+constexpr std::size_t num_feeds = 4;
+
+struct FeedEvent {
+    std::uint64_t exchange_ts;
+    std::uint32_t feed_id;
+    std::uint32_t sequence;
+};
+
+struct ExchangeTimestamp {
+    std::uint64_t operator()(const FeedEvent& event) const noexcept { return event.exchange_ts; }
+};
+
+using QueueType  = foundry_runtime::spsc_queue<FeedEvent, 1024, true, false>;
+using MergerType = foundry_runtime::timestamp_merger<QueueType, num_feeds, ExchangeTimestamp>;
+
+/*
+Silent Feed:
+    - feeds 1..3 keep going while feed 0 never sends anything
+    - with a finite lateness the merge skips feed 0 once the others are `lateness` ahead instead of stalling forever
+    - the live feeds still hold each other back: feed 1 ends at 491, so feed 2's 492 and feed 3's 493 wait for it
+*/
+bool silentFeedIsSkipped() {
+    std::array<std::unique_ptr<QueueType>, num_feeds> queues;
+    std::array<QueueType*, num_feeds> inputs;
+    for (std::size_t f = 0; f < num_feeds; ++f) {
+        queues[f] = std::make_unique<QueueType>();
+        inputs[f] = queues[f].get();
+    }
+    MergerType merger(inputs, 100);
+
+    for (std::size_t f = 1; f < num_feeds; ++f) {
+        for (std::uint32_t i = 0; i < 50; ++i) queues[f]->try_enqueue(FeedEvent{std::uint64_t(i) * 10 + f, std::uint32_t(f), i});
+    }
+
+    std::uint64_t emitted = 0;
+    for (int round = 0; round < 4; ++round) emitted += merger.poll([](const FeedEvent&) {});
+
+    std::cout << "Silent Feed Emitted=" << emitted << " Late=" << merger.late_count() << "\n";
+    return emitted == 148 && merger.late_count() == 0;
+}
+
+/*
+Feed Merge:
+    - every feed thread produces events with increasing (but feed specific, jittered) exchange timestamps
+    - the merge runs with an unbounded lateness, so it must wait on quiet feeds and the output must be globally ordered
+    - every event has to come out exactly once
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t per_feed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500'000;
+
+    std::array<std::unique_ptr<QueueType>, num_feeds> queues;
+    std::array<QueueType*, num_feeds> inputs;
+    for (std::size_t f = 0; f < num_feeds; ++f) {
+        queues[f] = std::make_unique<QueueType>();
+        inputs[f] = queues[f].get();
+    }
+
+    auto merger = std::make_unique<MergerType>(inputs, std::numeric_limits<std::uint64_t>::max());
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> feeds;
+    for (std::size_t f = 0; f < num_feeds; ++f) {
+        feeds.emplace_back([&, f] {
+            std::uint64_t ts = f;
+            for (std::uint32_t i = 0; i < per_feed; ++i) {
+                ts += 1 + (i * 7 + f * 13) % 11; // each feed advances at its own uneven pace
+                while (!queues[f]->try_enqueue(FeedEvent{ts, std::uint32_t(f), i})) std::this_thread::yield();
+            }
+            // one final sentinel far in the future so the merge can flush everything before it (it is never emitted)
+            while (!queues[f]->try_enqueue(FeedEvent{std::numeric_limits<std::uint64_t>::max() - 1, std::uint32_t(f), std::uint32_t(per_feed)})) std::this_thread::yield();
+        });
+    }
+
+    const std::uint64_t total = per_feed * num_feeds;
+    std::uint64_t emitted = 0, out_of_order = 0, last_ts = 0;
+    std::vector<std::uint32_t> next_sequence(num_feeds, 0);
+    std::uint64_t bad_sequence = 0;
+
+    while (emitted < total) {
+        const std::size_t count = merger->poll([&](const FeedEvent& event) {
+            out_of_order += event.exchange_ts < last_ts;
+            last_ts = event.exchange_ts;
+            bad_sequence += event.sequence != next_sequence[event.feed_id]++;
+        }, total - emitted);
+
+        emitted += count;
+        if (count == 0) std::this_thread::yield();
+    }
+    for (auto& feed : feeds) feed.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Feeds=" << num_feeds << " Emitted=" << emitted << " Expected=" << total << "\n";
+    std::cout << "Out Of Order=" << out_of_order << " Bad Sequence=" << bad_sequence << " Late=" << merger->late_count() << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    const bool skipped = silentFeedIsSkipped();
+
+    return (emitted == total && out_of_order == 0 && bad_sequence == 0 && skipped) ? 0 : 1;
+}
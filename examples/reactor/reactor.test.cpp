@@ -0,0 +1,85 @@
+#include <foundry_runtime/reactor/reactor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+
+using Runtime = foundry_runtime::reactor_runtime<>;
+
+// shard state is only ever touched by its own reactor, so plain fields, padded so neighbouring shards don't share lines
+struct alignas(cacheline_size) Shard {
+    std::uint64_t visits = 0;
+};
+
+struct HopContext {
+    Runtime*                    runtime;
+    Shard*                      shards;
+    std::atomic<std::uint64_t>* finished;
+};
+
+// visit this core's shard, then forward the token to the next core until it runs out of hops
+void hop(const HopContext* context, std::uint32_t hops_left) {
+    Runtime& runtime = *context->runtime;
+    const std::size_t core = runtime.this_core();
+
+    context->shards[core].visits++;
+
+    if (hops_left == 0) {
+        context->finished->fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    const std::size_t next = (core + 1) % runtime.size();
+    while (!runtime.run_on(next, [context, hops_left] { hop(context, hops_left - 1); })) foundry_runtime::cpu_relax();
+}
+
+/*
+Token Ring:
+    - the driver thread injects tokens_per_core tokens on every core per round
+    - each token hops num_hops times around the ring of reactors, bumping each shard it lands on
+    - tokens in flight never exceed what the mesh queues can hold, so a reactor never spins on a full queue forever
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t rounds          = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    const std::uint32_t num_hops        = 16;
+    const std::uint64_t tokens_per_core = 32;
+    const std::size_t   num_reactors    = std::max(2u, std::min(4u, std::thread::hardware_concurrency()));
+
+    Runtime runtime(num_reactors);
+    std::vector<Shard> shards(num_reactors);
+    std::atomic<std::uint64_t> finished{0};
+    const HopContext context{&runtime, shards.data(), &finished};
+
+    runtime.start();
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t round = 0; round < rounds; ++round) {
+        for (std::size_t core = 0; core < num_reactors; ++core) {
+            for (std::uint64_t t = 0; t < tokens_per_core; ++t) {
+                while (!runtime.run_on(core, [&context, num_hops] { hop(&context, num_hops); })) std::this_thread::yield();
+            }
+        }
+        while (finished.load(std::memory_order_acquire) < (round + 1) * tokens_per_core * num_reactors) std::this_thread::yield();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    runtime.stop();
+
+    std::uint64_t total_visits = 0;
+    for (const Shard& shard : shards) total_visits += shard.visits;
+    const std::uint64_t expected_visits = rounds * tokens_per_core * num_reactors * (num_hops + 1);
+
+    std::cout << "Reactors=" << num_reactors << "\n";
+    std::cout << "Total Visits=" << total_visits << " Expected Visits=" << expected_visits << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+    std::cout << "ns/hop=" << std::chrono::duration<double, std::nano>(end - start).count() / double(total_visits) << "\n";
+
+    return total_visits == expected_visits ? 0 : 1;
+}
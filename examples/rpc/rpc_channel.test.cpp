@@ -0,0 +1,244 @@
+#include <foundry_runtime/rpc/rpc_channel.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+
+struct PriceRequest {
+    std::uint64_t instrument;
+    std::uint64_t quantity;
+};
+
+struct PriceResponse {
+    std::uint64_t instrument;
+    std::uint64_t notional;
+};
+
+std::uint64_t priceOf(const PriceRequest& request) { return (request.instrument % 97 + 100) * request.quantity; }
+
+template <foundry_runtime::rpc_wait wait_mode>
+using ChannelType = foundry_runtime::rpc_channel<PriceRequest, PriceResponse, 256, wait_mode>;
+
+/*
+Server:
+    - takes up to 32 requests at a time and answers them in reverse order, so the client can only match them by token
+    - stops after `number` requests
+*/
+template <class Channel>
+void runServer(Channel& channel, std::uint64_t number) {
+    typename Channel::submission requests[32];
+    typename Channel::completion responses[32];
+
+    std::uint64_t served = 0;
+    while (served < number) {
+        const std::size_t count = channel.wait_requests(requests, 32);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& request = requests[count - 1 - i];
+            responses[i] = {request.token, PriceResponse{request.request.instrument, priceOf(request.request)}};
+        }
+
+        std::size_t sent = 0;
+        while (sent < count) sent += channel.try_respond_bulk(responses + sent, count - sent);
+        served += count;
+    }
+}
+
+/*
+Pipelined Client:
+    - keeps up to 64 calls in flight, submitting in bulk and waiting for completions in bulk
+    - remembers token -> request and checks every completion against it
+*/
+template <foundry_runtime::rpc_wait wait_mode>
+bool runPipelined(const char* name, std::uint64_t number) {
+    using Channel = ChannelType<wait_mode>;
+    auto channel = std::make_unique<Channel>();
+
+    std::thread server([&] { runServer(*channel, number); });
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::unordered_map<std::uint64_t, PriceRequest> in_flight;
+    std::uint64_t submitted = 0, completed = 0, errors = 0;
+    PriceRequest  batch[16];
+    std::uint64_t tokens[16];
+    typename Channel::completion done[32];
+
+    while (completed < number) {
+        if (in_flight.size() <= 48 && submitted < number) {
+            std::size_t count = 0;
+            for (; count < 16 && submitted + count < number; ++count) batch[count] = PriceRequest{submitted + count, (submitted + count) % 10 + 1};
+
+            const std::size_t accepted = channel->try_submit_bulk(batch, count, tokens);
+            for (std::size_t i = 0; i < accepted; ++i) in_flight.emplace(tokens[i], batch[i]);
+            submitted += accepted;
+        }
+
+        const std::size_t count = in_flight.empty() ? 0 : channel->wait_completions(done, 32);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto request = in_flight.find(done[i].token);
+            if (request == in_flight.end()) {
+                errors++;
+                continue;
+            }
+            errors += done[i].response.instrument != request->second.instrument || done[i].response.notional != priceOf(request->second);
+            in_flight.erase(request);
+        }
+        completed += count;
+    }
+    server.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "mode=" << name << " pipelined calls=" << completed << " errors=" << errors
+              << " server_wakeups=" << channel->server_wakeups() << " client_wakeups=" << channel->client_wakeups()
+              << " time=" << std::chrono::duration<double>(end - start).count() << "\n";
+    return errors == 0;
+}
+
+/*
+Synchronous Calls:
+    - one call at a time through call(), the pattern the channel replaces hand built queue pairs for
+*/
+template <foundry_runtime::rpc_wait wait_mode>
+bool runSynchronous(const char* name, std::uint64_t number) {
+    using Channel = ChannelType<wait_mode>;
+    auto channel = std::make_unique<Channel>();
+
+    std::thread server([&] { runServer(*channel, number); });
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::uint64_t errors = 0;
+    PriceResponse response;
+    for (std::uint64_t i = 0; i < number; ++i) {
+        const PriceRequest request{i, i % 10 + 1};
+        errors += !channel->call(request, response) || response.notional != priceOf(request);
+    }
+    server.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "mode=" << name << " sync calls=" << number << " errors=" << errors
+              << " ns/call=" << std::chrono::duration<double, std::nano>(end - start).count() / double(number) << "\n";
+    return errors == 0;
+}
+
+/*
+Idle Gaps:
+    - the client pauses for a millisecond every few calls, long enough for the server to give up spinning and sleep
+    - so the futex path has to carry the wakeups, server_wakeups should be close to the number of gaps
+*/
+bool runWithGaps(std::uint64_t gaps) {
+    using Channel = ChannelType<foundry_runtime::rpc_wait::futex>;
+    auto channel = std::make_unique<Channel>();
+    const std::uint64_t number = gaps * 8;
+
+    std::thread server([&] { runServer(*channel, number); });
+
+    std::uint64_t errors = 0;
+    PriceResponse response;
+    for (std::uint64_t i = 0; i < number; ++i) {
+        if (i % 8 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const PriceRequest request{i, i % 10 + 1};
+        errors += !channel->call(request, response) || response.notional != priceOf(request);
+    }
+    server.join();
+
+    std::cout << "mode=futex gapped calls=" << number << " gaps=" << gaps << " errors=" << errors
+              << " server_wakeups=" << channel->server_wakeups() << "\n";
+    return errors == 0 && channel->server_wakeups() > 0;
+}
+
+/*
+Late Completion:
+    - the server sits on the first request past the client's timeout, so that call() gives up
+    - the late completion then arrives ahead of the next call's, which has to skip it and still get its own answer
+*/
+bool runLateCompletion() {
+    using Channel = ChannelType<foundry_runtime::rpc_wait::futex>;
+    auto channel = std::make_unique<Channel>();
+
+    std::thread server([&] {
+        typename Channel::submission request;
+        for (int served = 0; served < 3; ++served) {
+            while (channel->wait_requests(&request, 1) == 0) {}
+            if (served == 0) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            while (!channel->try_respond(request.token, PriceResponse{request.request.instrument, priceOf(request.request)})) {}
+        }
+    });
+
+    PriceResponse response;
+    const bool timed_out = !channel->call(PriceRequest{1, 1}, response, std::chrono::milliseconds(2));
+
+    std::uint64_t errors = 0;
+    for (std::uint64_t i = 2; i <= 3; ++i) {
+        const PriceRequest request{i, 1};
+        errors += !channel->call(request, response) || response.instrument != i || response.notional != priceOf(request);
+    }
+    server.join();
+
+    std::cout << "mode=futex late completion timed_out=" << timed_out << " errors=" << errors << "\n";
+    return timed_out && errors == 0;
+}
+
+/*
+Shared Memory:
+    - the channel is created in an anonymous MAP_SHARED mapping, the forked child attaches and serves
+    - futex waits go through the shared (non private) futex so they work across the two processes
+*/
+bool runCrossProcess(std::uint64_t number) {
+    using Channel = ChannelType<foundry_runtime::rpc_wait::futex>;
+
+    void* memory = ::mmap(nullptr, sizeof(Channel), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        std::cout << "shared memory: mmap failed, skipping\n";
+        return true;
+    }
+    Channel* channel = Channel::create_at(memory);
+
+    const pid_t child = ::fork();
+    if (child == 0) {
+        runServer(*Channel::attach(memory), number);
+        ::_exit(0);
+    }
+
+    std::uint64_t errors = 0;
+    PriceResponse response;
+    for (std::uint64_t i = 0; i < number; ++i) {
+        const PriceRequest request{i, i % 10 + 1};
+        errors += !channel->call(request, response) || response.notional != priceOf(request);
+    }
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    std::cout << "mode=shm_futex sync calls=" << number << " errors=" << errors << " child_status=" << status << "\n";
+
+    channel->~Channel();
+    ::munmap(memory, sizeof(Channel));
+    return errors == 0 && status == 0;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+    bool ok = true;
+    ok &= runPipelined<foundry_runtime::rpc_wait::poll>("poll", number);
+    ok &= runPipelined<foundry_runtime::rpc_wait::futex>("futex", number);
+    ok &= runSynchronous<foundry_runtime::rpc_wait::poll>("poll", number / 10);
+    ok &= runSynchronous<foundry_runtime::rpc_wait::futex>("futex", number / 10);
+    ok &= runWithGaps(200);
+    ok &= runLateCompletion();
+    ok &= runCrossProcess(number / 10);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include <foundry_runtime/spsc_poller/spsc_poller.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+
+constexpr std::size_t num_queues    = 128;
+constexpr std::size_t num_producers = 4;
+
+using QueueType  = foundry_runtime::spsc_queue<std::uint64_t, 256, true, false>;
+using PollerType = foundry_runtime::spsc_poller<QueueType, num_queues>;
+
+/*
+Sparse Fan-In:
+    - num_queues queues but only every 8th one is ever active, the rest stay idle the whole run (the common case for us)
+    - each producer thread owns an interleaved slice of the active queues and writes per queue sequence numbers
+    - the consumer polls the bitmap, checks every queue's sequence is in FIFO order and counts how many queue visits it made
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t per_queue = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+    auto poller = std::make_unique<PollerType>();
+
+    std::vector<std::size_t> active_queues;
+    for (std::size_t q = 0; q < num_queues; q += 8) active_queues.push_back(q);
+
+    // queue 0 gets a bigger share per visit, just to exercise the weights
+    poller->set_weight(0, 64);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < per_queue; ++i) {
+                for (std::size_t a = p; a < active_queues.size(); a += num_producers) {
+                    while (!poller->try_enqueue(active_queues[a], i)) std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> next_expected(num_queues, 0);
+    std::uint64_t received = 0, out_of_order = 0, polls = 0, empty_polls = 0;
+    const std::uint64_t total = per_queue * active_queues.size();
+
+    while (received < total) {
+        const std::size_t handled = poller->poll([&](std::size_t queue_index, std::uint64_t value) {
+            out_of_order += value != next_expected[queue_index];
+            next_expected[queue_index] = value + 1;
+        });
+        received += handled;
+        polls++;
+        if (handled == 0) {
+            empty_polls++;
+            std::this_thread::yield();
+        }
+    }
+    for (auto& producer : producers) producer.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Queues=" << num_queues << " Active=" << active_queues.size() << "\n";
+    std::cout << "Received=" << received << " Expected=" << total << " Out Of Order=" << out_of_order << "\n";
+    std::cout << "Polls=" << polls << " Empty Polls=" << empty_polls << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    return (received == total && out_of_order == 0) ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_eventfd_channel.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+
+
+using ChannelType = foundry_runtime::spsc_eventfd_channel<foundry_runtime::spsc_queue<std::uint64_t, 1024, true, false>>;
+
+/*
+Sleeping Consumer:
+    - the producer sends bursts of burst_size messages with a pause between bursts, like a feed that goes quiet
+    - the consumer drains, parks, and sleeps in epoll_wait on the channel's eventfd (as it would next to its sockets)
+    - wakeups should track the number of bursts, not the number of messages
+    - odd bursts go through try_enqueue_bulk in chunks of 32, one fence per chunk instead of one per message
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t bursts     = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    const std::uint64_t burst_size = 512;
+    const std::uint64_t total      = bursts * burst_size;
+
+    ChannelType channel;
+
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event registration{};
+    registration.events  = EPOLLIN;
+    registration.data.fd = channel.fd();
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, channel.fd(), &registration);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&channel, bursts, burst_size] {
+        std::uint64_t value = 0;
+        for (std::uint64_t b = 0; b < bursts; ++b) {
+            if (b % 2 == 0) {
+                for (std::uint64_t i = 0; i < burst_size; ++i) {
+                    while (!channel.try_enqueue(value)) std::this_thread::yield();
+                    value++;
+                }
+            } else {
+                std::uint64_t chunk[32];
+                for (std::uint64_t sent = 0; sent < burst_size;) {
+                    for (std::uint64_t i = 0; i < 32; ++i) chunk[i] = value + i;
+                    std::size_t done = 0;
+                    while (done < 32) {
+                        const std::size_t enqueued = channel.try_enqueue_bulk(chunk + done, 32 - done);
+                        if (enqueued == 0) std::this_thread::yield();
+                        done += enqueued;
+                    }
+                    value += 32;
+                    sent  += 32;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::uint64_t received = 0, out_of_order = 0, sleeps = 0, value;
+    while (received < total) {
+        while (channel.try_dequeue(value)) {
+            out_of_order += value != received;
+            received++;
+        }
+        if (received == total || !channel.prepare_park()) continue;
+
+        epoll_event ready[4];
+        sleeps++;
+        const int count = ::epoll_wait(epoll_fd, ready, 4, 1000);
+        if (count > 0) channel.on_readable();
+        else channel.cancel_park();
+    }
+    producer.join();
+
+    auto end = std::chrono::steady_clock::now();
+    ::close(epoll_fd);
+
+    std::cout << "Bursts=" << bursts << " Messages=" << total << "\n";
+    std::cout << "Received=" << received << " Out Of Order=" << out_of_order << "\n";
+    std::cout << "Sleeps=" << sleeps << " Eventfd Wakeups=" << channel.wakeups() << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    return (received == total && out_of_order == 0) ? 0 : 1;
+}
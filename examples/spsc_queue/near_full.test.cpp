@@ -0,0 +1,82 @@
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_bqueue.h>
+#include <foundry_runtime/spsc_queue/spsc_stats.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+/*
+Near Full:
+    - the consumer burns consumer_work pauses per element, so it is always slower than the producer
+    - we report throughput and how many shared index reads (spsc_queue refreshes / bqueue probes) the producer needed per enqueue
+    - spsc_queue only refreshes read_next when its cached copy says full, and each refresh hands it every slot the
+      consumer freed since, so its count is "how often did the producer catch up with the consumer", not one per enqueue
+        - with the two threads on separate cores and the consumer draining one slot at a time that can approach one per
+          enqueue, that is the case the bqueue's one probe per batch is for
+        - time sliced on one core it is about one per scheduling quantum (see the results below)
+*/
+template <class QueueType>
+void runNearFull(const char* config_name, std::uint64_t number, std::uint32_t consumer_work, const foundry_runtime::tsc_clock& clock) {
+    auto queue = std::make_unique<QueueType>();
+
+    const std::uint64_t start = foundry_runtime::read_tsc();
+
+    std::thread consumer([&queue, number, consumer_work] {
+        std::uint64_t dequeued_value;
+        for (std::uint64_t remaining = number; remaining > 0;) {
+            if (!queue->try_dequeue(dequeued_value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::uint32_t i = 0; i < consumer_work; ++i) foundry_runtime::cpu_relax();
+            remaining--;
+        }
+    });
+
+    for (std::uint64_t i = 0; i < number; ++i) {
+        while (!queue->try_enqueue(i)) std::this_thread::yield();
+    }
+    consumer.join();
+
+    const double elapsed_ns = clock.to_ns(foundry_runtime::read_tsc() - start);
+    const auto   stats      = queue->stats();
+
+    std::cout << "config=" << config_name
+              << " ns/op=" << (elapsed_ns / double(number))
+              << " producer_index_reads/op=" << (double(stats.producer_cache_refreshes) / double(number))
+              << " failed_enqueues=" << stats.failed_enqueues << "\n";
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t number        = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+    const std::uint32_t consumer_work = argc > 2 ? std::uint32_t(std::strtoul(argv[2], nullptr, 10)) : 4;
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate();
+
+    using foundry_runtime::spsc_counting_stats;
+    runNearFull<foundry_runtime::spsc_queue<std::uint64_t, 1024, true, false, spsc_counting_stats>>("spsc_queue",  number, consumer_work, clock);
+    runNearFull<foundry_runtime::spsc_bqueue<std::uint64_t, 1024, 8,   spsc_counting_stats>>("bqueue_b8",   number, consumer_work, clock);
+    runNearFull<foundry_runtime::spsc_bqueue<std::uint64_t, 1024, 64,  spsc_counting_stats>>("bqueue_b64",  number, consumer_work, clock);
+    runNearFull<foundry_runtime::spsc_bqueue<std::uint64_t, 1024, 256, spsc_counting_stats>>("bqueue_b256", number, consumer_work, clock);
+
+    return 0;
+}
+
+/*
+Results
+
+Single core VM (producer and consumer time slice), runNearFull 2'000'000 4
+    config=spsc_queue  ns/op=88.9 producer_index_reads/op=0.0020 failed_enqueues=1955
+    config=bqueue_b8   ns/op=95.8 producer_index_reads/op=0.1289 failed_enqueues=1953
+    config=bqueue_b64  ns/op=86.1 producer_index_reads/op=0.0225 failed_enqueues=1953
+    config=bqueue_b256 ns/op=82.9 producer_index_reads/op=0.0127 failed_enqueues=1953
+    - the producer fills the whole ring every time it runs, so spsc_queue refreshes once per fill (~ once per failed
+      enqueue), while the bqueue probes once per batch regardless, which is why b8 reads the shared state the most here
+    - the per-enqueue refresh trickle the bqueue targets needs a real core pair, rerun there before drawing conclusions
+*/
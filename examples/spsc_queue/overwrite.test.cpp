@@ -0,0 +1,59 @@
+#include <foundry_runtime/spsc_queue/spsc_overwrite_queue.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+
+
+/*
+Overwrite:
+    - the producer enqueues 1..number as fast as it can, it never waits
+    - the consumer checks every value it gets is strictly increasing, so resyncs never go backwards or repeat
+    - at the end every position was either delivered or counted as lost, so received + lost must equal number
+*/
+template <class QueueType>
+int runOverwrite(const char* config_name, std::uint64_t number) {
+    QueueType queue;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (std::uint64_t i = 1; i <= number; ++i) queue.enqueue(i);
+        done.store(true, std::memory_order_release);
+    });
+
+    std::uint64_t received = 0, out_of_order = 0, last_value = 0, value;
+    for (;;) {
+        const bool producer_done = done.load(std::memory_order_acquire);
+        if (queue.try_dequeue(value)) {
+            received++;
+            out_of_order += value <= last_value;
+            last_value    = value;
+        } else if (producer_done) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    std::cout << "config=" << config_name
+              << " enqueued=" << number
+              << " received=" << received
+              << " lost=" << queue.lost()
+              << " out_of_order=" << out_of_order << "\n";
+
+    return (out_of_order == 0 && received + queue.lost() == number) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+
+    int failures = 0;
+    failures += runOverwrite<foundry_runtime::spsc_overwrite_queue<std::uint64_t, 16>>  ("overwrite_16",   number);
+    failures += runOverwrite<foundry_runtime::spsc_overwrite_queue<std::uint64_t, 1024>>("overwrite_1024", number);
+
+    return failures;
+}
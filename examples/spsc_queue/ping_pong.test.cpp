@@ -0,0 +1,108 @@
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_micro_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_ff_queue.h>
+#include <foundry_runtime/hdr_histogram/hdr_histogram.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+struct SpinWait  { static constexpr const char* name = "spin";  void operator()() const noexcept { foundry_runtime::cpu_relax(); } };
+struct YieldWait { static constexpr const char* name = "yield"; void operator()() const noexcept { std::this_thread::yield(); } };
+
+struct LatencyResult {
+    foundry_runtime::hdr_histogram<> round_trip_ns;
+    foundry_runtime::hdr_histogram<> one_way_ns;
+};
+
+/*
+Ping-Pong:
+    1. the pinger stamps the tsc and pushes the stamp through the ping queue
+    2. the ponger pops it and pushes it straight back through the pong queue
+    3. the pinger pops its own stamp and records (now - stamp) as the round trip
+    4. one way latency is estimated as half the round trip (no cross core clock comparison needed)
+    5. the first warmup_iterations round trips are thrown away so page faults and cold caches don't land in the tail
+*/
+template <class QueueType, class WaitStrategy>
+LatencyResult runPingPong(std::uint64_t iterations, std::uint64_t warmup_iterations, const foundry_runtime::tsc_clock& clock) {
+    auto ping = std::make_unique<QueueType>();
+    auto pong = std::make_unique<QueueType>();
+    WaitStrategy wait;
+
+    std::thread ponger([&] {
+        std::uint64_t stamp;
+        for (std::uint64_t i = 0; i < iterations + warmup_iterations; ++i) {
+            while (!ping->try_dequeue(stamp)) wait();
+            while (!pong->try_enqueue(stamp)) wait();
+        }
+    });
+
+    LatencyResult result;
+    std::uint64_t returned_stamp;
+    for (std::uint64_t i = 0; i < iterations + warmup_iterations; ++i) {
+        const std::uint64_t sent_stamp = foundry_runtime::read_tsc();
+        while (!ping->try_enqueue(sent_stamp)) wait();
+        while (!pong->try_dequeue(returned_stamp)) wait();
+
+        const std::uint64_t round_trip_ticks = foundry_runtime::read_tsc_ordered() - returned_stamp;
+        if (i < warmup_iterations) continue;
+
+        const auto round_trip_ns = static_cast<std::uint64_t>(clock.to_ns(round_trip_ticks));
+        result.round_trip_ns.record(round_trip_ns);
+        result.one_way_ns.record(round_trip_ns / 2);
+    }
+
+    ponger.join();
+    return result;
+}
+
+void printHistogram(const char* label, const foundry_runtime::hdr_histogram<>& histogram) {
+    std::cout << "    " << label
+              << " p50="   << histogram.value_at_percentile(50.0)
+              << " p99="   << histogram.value_at_percentile(99.0)
+              << " p99.9=" << histogram.value_at_percentile(99.9)
+              << " max="   << histogram.max() << "\n";
+}
+
+template <class QueueType, class WaitStrategy>
+void runConfig(const char* config_name, std::uint64_t iterations, const foundry_runtime::tsc_clock& clock) {
+    const LatencyResult result = runPingPong<QueueType, WaitStrategy>(iterations, iterations / 10, clock);
+
+    std::cout << "config=" << config_name << " wait=" << WaitStrategy::name << " samples=" << result.round_trip_ns.count()
+              << " queue_bytes=" << sizeof(QueueType) << "\n";
+    printHistogram("round_trip_ns", result.round_trip_ns);
+    printHistogram("one_way_ns   ", result.one_way_ns);
+}
+
+template <class WaitStrategy>
+void runAllConfigs(std::uint64_t iterations, const foundry_runtime::tsc_clock& clock) {
+    runConfig<foundry_runtime::spsc_queue<std::uint64_t, 128, false, false>, WaitStrategy>("unpadded",        iterations, clock);
+    runConfig<foundry_runtime::spsc_queue<std::uint64_t, 128, true,  false>, WaitStrategy>("padded",          iterations, clock);
+    runConfig<foundry_runtime::spsc_queue<std::uint64_t, 128, true,  true >, WaitStrategy>("padded+prefetch", iterations, clock);
+    runConfig<foundry_runtime::spsc_ff_queue<std::uint64_t, 128>,            WaitStrategy>("fastforward",     iterations, clock);
+
+    // tiny control ring sizes, padded spsc_queue against the packed micro layout
+    runConfig<foundry_runtime::spsc_queue<std::uint64_t, 8, true, false>, WaitStrategy>("padded_8", iterations, clock);
+    runConfig<foundry_runtime::spsc_micro_queue<std::uint64_t, 8>,        WaitStrategy>("micro_8",  iterations, clock);
+    runConfig<foundry_runtime::spsc_micro_queue<std::uint64_t, 4>,        WaitStrategy>("micro_4",  iterations, clock);
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate();
+    std::cout << "tsc ticks/ns=" << clock.ticks_per_ns() << "\n";
+
+    // spinning with a single hardware thread just burns both time slices, the numbers would be scheduler noise
+    if (std::thread::hardware_concurrency() > 1) runAllConfigs<SpinWait>(iterations, clock);
+    else std::cout << "skipping wait=spin, only one hardware thread available\n";
+
+    runAllConfigs<YieldWait>(iterations, clock);
+
+    return 0;
+}
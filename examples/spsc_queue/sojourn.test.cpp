@@ -0,0 +1,114 @@
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_sojourn.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+constexpr std::uint32_t sample_every = 64;
+
+using EdgeQueue = foundry_runtime::spsc_queue<std::uint64_t, 1024, true, false, foundry_runtime::spsc_sojourn_stats<sample_every>>;
+
+struct EdgeReport {
+    std::uint64_t samples;
+    std::uint64_t p50_ns;
+    std::uint64_t p99_ns;
+    std::uint64_t max_ns;
+};
+
+EdgeReport reportOf(const EdgeQueue& edge, const foundry_runtime::tsc_clock& clock) {
+    const auto snapshot = edge.slot_stamps().sojourn_ticks.snapshot();
+    return {snapshot.count(), clock.ticks_to_ns(snapshot.value_at_percentile(50.0)),
+            clock.ticks_to_ns(snapshot.value_at_percentile(99.0)), clock.ticks_to_ns(snapshot.max())};
+}
+
+void busyFor(std::uint64_t ticks) {
+    const std::uint64_t start = foundry_runtime::read_tsc();
+    while (foundry_runtime::read_tsc() - start < ticks) foundry_runtime::cpu_relax();
+}
+
+/*
+Two Edge Pipeline:
+    - source -> edge "parse" -> stage -> edge "risk" -> sink
+    - the stage keeps up easily, the sink spends ~2us per message, so "risk" backs up and its sojourn times grow
+    - a monitor thread snapshots both edges' histograms while everything runs and alarms when an edge's p99 breaks the SLO
+    - every sample_every-th message on each edge must have been sampled, no more and no fewer
+*/
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const std::uint64_t slo_ns = 50'000;
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate();
+
+    auto parse = std::make_unique<EdgeQueue>();
+    auto risk  = std::make_unique<EdgeQueue>();
+    std::atomic<bool> done{false};
+
+    std::thread monitor([&] {
+        std::uint64_t alarms_parse = 0, alarms_risk = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            alarms_parse += reportOf(*parse, clock).p99_ns > slo_ns;
+            alarms_risk  += reportOf(*risk,  clock).p99_ns > slo_ns;
+        }
+        std::cout << "Monitor SLO ns=" << slo_ns << " Alarms parse=" << alarms_parse << " risk=" << alarms_risk << "\n";
+    });
+
+    std::thread sink([&] {
+        const std::uint64_t work_ticks = clock.ns_to_ticks(2'000);
+        std::uint64_t value, received = 0, out_of_order = 0;
+        while (received < number) {
+            if (!risk->try_dequeue(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            out_of_order += value != received++;
+            busyFor(work_ticks);
+        }
+        if (out_of_order) std::cout << "Sink Out Of Order=" << out_of_order << "\n";
+    });
+
+    std::thread stage([&] {
+        std::uint64_t batch[32], forwarded = 0;
+        while (forwarded < number) {
+            const std::size_t count = parse->try_dequeue_bulk(batch, 32);
+            if (count == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::size_t sent = 0;
+            while (sent < count) {
+                const std::size_t pushed = risk->try_enqueue_bulk(batch + sent, count - sent);
+                if (pushed == 0) std::this_thread::yield();
+                sent += pushed;
+            }
+            forwarded += count;
+        }
+    });
+
+    for (std::uint64_t i = 0; i < number; ++i) {
+        while (!parse->try_enqueue(i)) std::this_thread::yield();
+    }
+
+    stage.join();
+    sink.join();
+    done.store(true, std::memory_order_release);
+    monitor.join();
+
+    const EdgeReport parse_report = reportOf(*parse, clock);
+    const EdgeReport risk_report  = reportOf(*risk,  clock);
+
+    std::cout << "Edge=parse Samples=" << parse_report.samples << " p50_ns=" << parse_report.p50_ns << " p99_ns=" << parse_report.p99_ns << " max_ns=" << parse_report.max_ns << "\n";
+    std::cout << "Edge=risk  Samples=" << risk_report.samples  << " p50_ns=" << risk_report.p50_ns  << " p99_ns=" << risk_report.p99_ns  << " max_ns=" << risk_report.max_ns  << "\n";
+    std::cout << "Queue Bytes=" << sizeof(EdgeQueue) << " Plain Queue Bytes=" << sizeof(foundry_runtime::spsc_queue<std::uint64_t, 1024, true, false>) << "\n";
+
+    const std::uint64_t expected_samples = number / sample_every;
+    return (parse_report.samples == expected_samples && risk_report.samples == expected_samples) ? 0 : 1;
+}
@@ -1,8 +1,14 @@
 #include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/hdr_histogram/hdr_histogram.h>
+#include <foundry_runtime/perf/perf_counters.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
 
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <tuple>
 #include <utility>
@@ -18,7 +24,7 @@ template <class QueueType>
 ThreadPair dispatchThreads(QueueType& queue, std::uint64_t number) {
 
     ProducerThread producer{
-        std::thread([&] {
+        std::thread([&queue, number] {
             for (uint64_t i = 0; i < number; ++i) {
                 while (!queue.try_enqueue(i)) {
                     std::this_thread::yield();
@@ -28,7 +34,7 @@ ThreadPair dispatchThreads(QueueType& queue, std::uint64_t number) {
     };
 
     ConsumerThread consumer{
-        std::thread([&] {
+        std::thread([&queue, number] {
             uint64_t decrementor = number;
             uint64_t dequeued_value;
             while (decrementor > 0) {
@@ -43,18 +49,109 @@ ThreadPair dispatchThreads(QueueType& queue, std::uint64_t number) {
 
 
 template <class QueueType>
-double runSim(std::uint64_t number) {
+double runSim(std::uint64_t number, const foundry_runtime::tsc_clock& clock) {
     QueueType queue;
 
-    auto start = std::chrono::steady_clock::now();
+    const std::uint64_t start = foundry_runtime::read_tsc();
     
     ThreadPair threads = dispatchThreads(queue, number);
     std::get<ProducerThread>(threads).producer.join();
     std::get<ConsumerThread>(threads).consumer.join();
 
-    auto end  = std::chrono::steady_clock::now();
+    const std::uint64_t end = foundry_runtime::read_tsc_ordered();
 
-    return std::chrono::duration<double>(end - start).count();
+    return clock.to_ns(end - start) / 1e9;
+}
+
+/*
+Per Message Latency:
+    - the producer enqueues its tsc stamp as the payload, the consumer records now - stamp for every message
+    - only affordable because a stamp is one rdtsc and the conversion one multiply + shift
+*/
+template <class QueueType>
+foundry_runtime::hdr_histogram<> runLatencySim(std::uint64_t number, const foundry_runtime::tsc_clock& clock) {
+    QueueType queue;
+    foundry_runtime::hdr_histogram<> latency_ns;
+
+    std::thread producer([&queue, number] {
+        for (uint64_t i = 0; i < number; ++i) {
+            while (!queue.try_enqueue(foundry_runtime::read_tsc())) std::this_thread::yield();
+        }
+    });
+
+    uint64_t stamp;
+    for (uint64_t received = 0; received < number;) {
+        if (!queue.try_dequeue(stamp)) {
+            std::this_thread::yield();
+            continue;
+        }
+        latency_ns.record(clock.ticks_to_ns(foundry_runtime::read_tsc() - stamp));
+        received++;
+    }
+    producer.join();
+
+    return latency_ns;
+}
+
+// what one stamp costs, the reason the sims above don't call steady_clock per message
+template <class ReadFn>
+double stampCostNs(ReadFn read, const foundry_runtime::tsc_clock& clock) {
+    constexpr int reads = 1'000'000;
+    std::uint64_t sink = 0;
+
+    const std::uint64_t start = foundry_runtime::read_tsc();
+    for (int i = 0; i < reads; ++i) sink += read();
+    const std::uint64_t end = foundry_runtime::read_tsc_ordered();
+
+    volatile std::uint64_t keep = sink; (void)keep;
+    return clock.to_ns(end - start) / reads;
+}
+
+/*
+Counted Sim:
+    - the same sim with hardware counters around it, normalized per message (one enqueue + one dequeue)
+    - this is what explains the timings: padding should show up as fewer c2c transfers / llc misses per op, prefetch as
+      fewer l1d misses on big rings, yields as context switches
+    - counters that didn't open print n/a, in a container without a pmu that is usually everything but the switches
+*/
+template <class QueueType>
+void runCountedSim(const char* config_name, std::uint64_t number, foundry_runtime::perf_counters& counters, const foundry_runtime::tsc_clock& clock) {
+    using foundry_runtime::perf_event_kind;
+
+    auto queue = std::make_unique<QueueType>();
+
+    counters.start();
+    const std::uint64_t start = foundry_runtime::read_tsc();
+
+    ThreadPair threads = dispatchThreads(*queue, number);
+    std::get<ProducerThread>(threads).producer.join();
+    std::get<ConsumerThread>(threads).consumer.join();
+
+    const std::uint64_t end = foundry_runtime::read_tsc_ordered();
+    const auto reading = counters.stop();
+
+    std::cout << "Counters config=" << config_name << " ns/op=" << clock.to_ns(end - start) / double(number);
+    for (std::size_t i = 0; i < foundry_runtime::perf_event_count; ++i) {
+        const auto kind = perf_event_kind(i);
+        std::cout << " " << foundry_runtime::perf_event_name(kind) << "/op=";
+        if (reading.has(kind)) std::cout << reading.per_op(kind, number);
+        else std::cout << "n/a";
+    }
+    std::cout << " ipc=";
+    if (reading.ipc() >= 0) std::cout << reading.ipc();
+    else std::cout << "n/a";
+    std::cout << "\n";
+}
+
+template <class QueueType>
+foundry_runtime::spsc_stats_snapshot runInstrumentedSim(std::uint64_t number) {
+    QueueType queue;
+
+    ThreadPair threads = dispatchThreads(queue, number);
+    std::get<ProducerThread>(threads).producer.join();
+    std::get<ConsumerThread>(threads).consumer.join();
+
+    return queue.stats();
 }
 
 int main() {
@@ -62,11 +159,14 @@ int main() {
     constexpr uint64_t number   = 5'000'000;
     constexpr uint8_t  num_sims = 10;
 
+    auto clock = foundry_runtime::tsc_clock::calibrate();
+    std::cout << "TSC Ticks/ns=" << clock.ticks_per_ns() << " Invariant=" << clock.invariant() << "\n";
+
     std::vector<double> sim_times;
     sim_times.reserve(num_sims);
     
     for (uint8_t i = 0; i < num_sims; i++) {
-        sim_times.emplace_back(runSim<foundry_runtime::spsc_queue<std::uint64_t, 128, true, false>>(number));
+        sim_times.emplace_back(runSim<foundry_runtime::spsc_queue<std::uint64_t, 128, true, false>>(number, clock));
     }
 
     double cumulative_time = 0;
@@ -78,6 +178,38 @@ int main() {
     std::cout << "Average Sim Time=" << (cumulative_time / num_sims) << "\n";
     std::cout << "Num Entries=" << int(number) << "\n";
 
+    const auto stats = runInstrumentedSim<foundry_runtime::spsc_queue<std::uint64_t, 128, true, false, foundry_runtime::spsc_counting_stats>>(number);
+    std::cout << "Failed Enqueues=" << stats.failed_enqueues << "\n";
+    std::cout << "Failed Dequeues=" << stats.failed_dequeues << "\n";
+    std::cout << "Producer Cache Hits/Refreshes=" << stats.producer_cache_hits << "/" << stats.producer_cache_refreshes << "\n";
+    std::cout << "Consumer Cache Hits/Refreshes=" << stats.consumer_cache_hits << "/" << stats.consumer_cache_refreshes << "\n";
+    std::cout << "High Water Occupancy=" << stats.high_water_occupancy << "\n";
+
+    const auto latency = runLatencySim<foundry_runtime::spsc_queue<std::uint64_t, 128, true, false>>(number, clock);
+    std::cout << "Message Latency ns p50=" << latency.value_at_percentile(50.0) << " p99=" << latency.value_at_percentile(99.0)
+              << " p99.9=" << latency.value_at_percentile(99.9) << " max=" << latency.max() << "\n";
+
+    // FOUNDRY_PERF_C2C_RAW=0x04d2 (skylake+ XSNP_HITM) or whatever this cpu's hitm/snoop event is, see perf list
+    const char* c2c_raw = std::getenv("FOUNDRY_PERF_C2C_RAW");
+    foundry_runtime::perf_counters counters(c2c_raw ? std::strtoull(c2c_raw, nullptr, 0) : 0);
+    std::cout << "Perf Counters available=" << counters.available();
+    if (counters.first_error()) std::cout << " first_error=" << std::strerror(counters.first_error());
+    std::cout << "\n";
+
+    runCountedSim<foundry_runtime::spsc_queue<std::uint64_t, 128,   false, false>>("plain",              number, counters, clock);
+    runCountedSim<foundry_runtime::spsc_queue<std::uint64_t, 128,   true,  false>>("padded",             number, counters, clock);
+    runCountedSim<foundry_runtime::spsc_queue<std::uint64_t, 128,   true,  true >>("padded+prefetch",    number, counters, clock);
+    runCountedSim<foundry_runtime::spsc_queue<std::uint64_t, 65536, true,  false>>("padded_64k",         number, counters, clock);
+    runCountedSim<foundry_runtime::spsc_queue<std::uint64_t, 65536, true,  true >>("padded_64k+prefetch", number, counters, clock);
+
+    // the sims above ran for seconds, measuring against the startup anchor again gives a much longer baseline
+    const double startup_ticks_per_ns = clock.ticks_per_ns();
+    clock.recalibrate();
+    std::cout << "TSC Recalibrated Ticks/ns=" << clock.ticks_per_ns() << " Drift ppm=" << (clock.ticks_per_ns() / startup_ticks_per_ns - 1.0) * 1e6 << "\n";
+
+    std::cout << "Stamp Cost ns read_tsc=" << stampCostNs([] { return foundry_runtime::read_tsc(); }, clock)
+              << " steady_clock=" << stampCostNs([] { return std::uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()); }, clock) << "\n";
+
     return 0;
 }
 
@@ -119,4 +251,32 @@ With forced power of two Array Size
     Num Entries=5000000
 
 // PREFETCH SEEMS TO HELP WHEN I DRASTICALLY INCREASE BUFFER SIZE
-*/
\ No newline at end of file
+
+Side-Owned Lines (index + cached peer index + counters on one line per side)
+    metadata lines touched per cache-hit op: 2 -> 1 (write_next + cached_read_loc used to be separate lines, same for the consumer)
+    sizeof(spsc_queue<uint64_t, 128, true, false>): 1280 -> 1152
+    NOTE: runs below are on a single core box, both threads time slice so this is mostly scheduler noise, rerun on a real core pair
+    Before (separate cached lines)
+        runSim<foundry_runtime::spsc_queue<std::uint64_t, 128, true, false>>(number)
+        Num Sims=10
+        Average Sim Time=0.0556
+        Num Entries=5000000
+        ping_pong padded yield round_trip_ns p50=1087 p99=1695 p99.9=2943
+    After (side-owned lines)
+        runSim<foundry_runtime::spsc_queue<std::uint64_t, 128, true, false>>(number)
+        Num Sims=10
+        Average Sim Time=0.0592
+        Num Entries=5000000
+        ping_pong padded yield round_trip_ns p50=1087 p99=1503 p99.9=2175
+
+TSC Timing (sim times now come from read_tsc/read_tsc_ordered instead of steady_clock::now)
+    stamp cost on this box (a VM, rdtsc is slower than on bare metal): read_tsc=21ns steady_clock=42ns
+    Message Latency ns p50=4351 p99=5631 p99.9=22527 (single core box, the yields dominate)
+
+Hardware Counters (runCountedSim, perf_event_open, per message)
+    this box is a VM with no pmu exposed (no cpu event source, perf_event_open gives ENOENT), so only the software
+    context switch count is real here, every hardware column prints n/a
+    Counters config=padded ns/op=23.6 context_switches/op=0.027
+    Counters config=padded_64k ns/op=2.6 context_switches/op=0.043 (the big ring lets each time slice run much longer)
+    rerun on bare metal with FOUNDRY_PERF_C2C_RAW set to see padding/prefetch in l1d/llc/hitm per op
+*/
@@ -0,0 +1,65 @@
+#include <foundry_runtime/spsc_queue/spsc_tuned.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+struct Quote {
+    std::uint64_t sequence;
+    std::uint64_t instrument;
+    double        bid;
+    double        ask;
+};
+
+/*
+Tuned Queue:
+    - prints the configuration spsc_tuned_queue resolved to for a few message sizes (measured if the autotuner's
+      header is on the include path, the defaults otherwise) and pushes quotes through the tuned queue
+*/
+template <class T>
+void printTuning(const char* name) {
+    constexpr auto tuning = foundry_runtime::spsc_tuning_for(sizeof(T));
+    std::cout << "type=" << name << " size=" << sizeof(T) << " capacity=" << tuning.capacity
+              << " padding=" << tuning.enable_cacheline_padding << " prefetch=" << tuning.enable_prefetch << "\n";
+}
+
+bool runTuned(std::uint64_t number) {
+    auto queue = std::make_unique<foundry_runtime::spsc_tuned_queue<Quote>>();
+
+    std::thread producer([&] {
+        for (std::uint64_t i = 0; i < number; ++i) {
+            while (!queue->try_enqueue(Quote{i, i % 64, 100.0, 100.5})) std::this_thread::yield();
+        }
+    });
+
+    std::uint64_t errors = 0;
+    Quote quote;
+    for (std::uint64_t expected = 0; expected < number;) {
+        if (!queue->try_dequeue(quote)) {
+            std::this_thread::yield();
+            continue;
+        }
+        errors += quote.sequence != expected++;
+    }
+    producer.join();
+
+    std::cout << "Tuned Quotes=" << number << " errors=" << errors << "\n";
+    return errors == 0;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    std::cout << "Measured=" << foundry_runtime::spsc_tuned_generated::measured
+              << " Host=" << foundry_runtime::spsc_tuned_generated::host << "\n";
+    printTuning<std::uint64_t>("uint64");
+    printTuning<Quote>("Quote");
+    printTuning<char[512]>("char[512]");
+    printTuning<char[4096]>("char[4096]");
+
+    return runTuned(number) ? 0 : 1;
+}
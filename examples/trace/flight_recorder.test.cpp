@@ -0,0 +1,149 @@
+#define FOUNDRY_TRACE_RUNTIME_EVENTS // park/wake events from the eventfd channel too
+
+#include <foundry_runtime/trace/flight_recorder.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_eventfd_channel.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+
+
+using foundry_runtime::flight_recorder;
+using foundry_runtime::trace_scope;
+
+using TracedQueue = foundry_runtime::spsc_queue<std::uint64_t, 256, true, false, foundry_runtime::spsc_trace_stats>;
+using ChannelType = foundry_runtime::spsc_eventfd_channel<foundry_runtime::spsc_queue<std::uint64_t, 256, true, false>>;
+
+/*
+Record Cost:
+    - a tight loop of instants on one thread, the ring wraps many times so this is the steady state cost
+*/
+double recordCostNs(std::uint64_t iterations, const foundry_runtime::tsc_clock& clock) {
+    const std::uint64_t start = foundry_runtime::read_tsc();
+    for (std::uint64_t i = 0; i < iterations; ++i) flight_recorder::instant("bench.instant", i);
+    return clock.to_ns(foundry_runtime::read_tsc() - start) / double(iterations);
+}
+
+/*
+Traced Pipeline:
+    - producer -> traced spsc_queue -> stage thread (trace_scope per batch) -> eventfd channel -> sleeping sink
+    - leaves enqueue/dequeue/empty events, stage begin/end pairs and park/wake events in three threads' rings
+*/
+void runPipeline(std::uint64_t number) {
+    auto queue   = std::make_unique<TracedQueue>();
+    auto channel = std::make_unique<ChannelType>();
+
+    std::thread sink([&] {
+        flight_recorder::name_thread("sink");
+
+        const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        epoll_event registration{};
+        registration.events = EPOLLIN;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, channel->fd(), &registration);
+
+        std::uint64_t received = 0, value;
+        while (received < number) {
+            while (channel->try_dequeue(value)) received++;
+            if (received == number || !channel->prepare_park()) continue;
+
+            epoll_event ready;
+            if (::epoll_wait(epoll_fd, &ready, 1, 100) > 0) channel->on_readable();
+            else channel->cancel_park();
+        }
+        ::close(epoll_fd);
+    });
+
+    std::thread stage([&] {
+        flight_recorder::name_thread("stage");
+
+        std::uint64_t batch[16], forwarded = 0;
+        while (forwarded < number) {
+            const std::size_t count = queue->try_dequeue_bulk(batch, 16);
+            if (count == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            trace_scope scope("stage.process", count);
+            for (std::size_t i = 0; i < count; ++i) {
+                while (!channel->try_enqueue(batch[i] * 2)) std::this_thread::yield();
+            }
+            forwarded += count;
+        }
+    });
+
+    flight_recorder::name_thread("producer");
+    for (std::uint64_t i = 0; i < number; ++i) {
+        while (!queue->try_enqueue(i)) std::this_thread::yield();
+        if (i % 256 == 255) std::this_thread::sleep_for(std::chrono::microseconds(200)); // gaps, so the sink parks
+    }
+
+    stage.join();
+    sink.join();
+}
+
+std::string readFile(const char* path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::size_t countOf(const std::string& text, const char* needle) {
+    std::size_t count = 0;
+    for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) count++;
+    return count;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t number   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000;
+    const char*         out_path = argc > 2 ? argv[2] : "flight_recorder.trace.json";
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate();
+    flight_recorder::set_clock(clock);
+
+    std::cout << "Record ns/op=" << recordCostNs(1'000'000, clock) << "\n";
+
+    runPipeline(number);
+
+    // on demand dump
+    const bool dumped = flight_recorder::dump_to_file(out_path);
+    const std::string trace = readFile(out_path);
+
+    std::cout << "Trace=" << out_path << " Bytes=" << trace.size() << " Threads=" << flight_recorder::threads_registered() << "\n";
+    std::cout << "Events enqueue=" << countOf(trace, "\"spsc.enqueue\"") << " dequeue=" << countOf(trace, "\"spsc.dequeue\"")
+              << " stage_begin=" << countOf(trace, "\"ph\":\"B\"") << " stage_end=" << countOf(trace, "\"ph\":\"E\"")
+              << " park=" << countOf(trace, "\"eventfd.park\"") << " wake=" << countOf(trace, "\"eventfd.wake\"") << "\n";
+
+    // signal dump, into a file opened up front
+    const std::string signal_path = std::string(out_path) + ".signal";
+    const int signal_fd = ::open(signal_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    flight_recorder::install_signal_handler(signal_fd);
+
+    flight_recorder::instant("before.signal");
+    std::raise(SIGUSR2);
+    ::close(signal_fd);
+
+    const std::string signal_trace = readFile(signal_path.c_str());
+    std::cout << "Signal Dump Bytes=" << signal_trace.size() << " Has Marker=" << (countOf(signal_trace, "before.signal") == 1) << "\n";
+
+    const bool ok = dumped && trace.front() == '{' && trace.find("\n]}") != std::string::npos
+        && countOf(trace, "\"ph\":\"E\"") - countOf(trace, "\"ph\":\"B\"") <= 1 // the ring may have dropped the oldest begin
+        && countOf(trace, "\"eventfd.park\"") > 0
+        && countOf(signal_trace, "before.signal") == 1;
+
+    std::remove(signal_path.c_str());
+    if (ok) std::remove(out_path); // keep the trace around when the checks failed, it is what you'd want to look at
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include <foundry_runtime/triple_buffer/triple_buffer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+
+
+// 32KB of state, every word is stamped with the generation so a reader seeing a half written block would notice
+struct StateBlock {
+    std::uint64_t words[4096];
+};
+
+int main(int argc, char** argv) {
+    const std::uint64_t generations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+    auto buffer = std::make_unique<foundry_runtime::triple_buffer<StateBlock>>();
+    std::atomic<bool> done{false};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread writer([&] {
+        for (std::uint64_t generation = 1; generation <= generations; ++generation) {
+            StateBlock& back = buffer->acquire_back();
+            for (auto& word : back.words) word = generation;
+            buffer->publish();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::uint64_t reads = 0, torn = 0, went_backwards = 0, last_generation = 0;
+    for (;;) {
+        const bool writer_done = done.load(std::memory_order_acquire);
+        if (!buffer->has_update()) {
+            if (writer_done) break;
+            std::this_thread::yield();
+            continue;
+        }
+
+        const StateBlock& front = buffer->latest();
+        reads++;
+        for (const auto word : front.words) torn += word != front.words[0];
+        went_backwards += front.words[0] < last_generation;
+        last_generation = front.words[0];
+    }
+    writer.join();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Generations=" << generations << "\n";
+    std::cout << "Reads=" << reads << "\n";
+    std::cout << "Torn=" << torn << "\n";
+    std::cout << "Went Backwards=" << went_backwards << "\n";
+    std::cout << "Last Generation=" << last_generation << "\n";
+    std::cout << "Time=" << std::chrono::duration<double>(end - start).count() << "\n";
+
+    return (torn == 0 && went_backwards == 0 && last_generation == generations) ? 0 : 1;
+}
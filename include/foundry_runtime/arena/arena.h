@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+namespace foundry_runtime {
+
+// header on the first line of every chunk, the payload starts on the next line
+struct alignas(cacheline_size) arena_chunk {
+    arena_chunk* next  = nullptr;
+    std::size_t  bytes = 0; // whole chunk, header included
+
+    std::byte* payload() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+    std::byte* end() noexcept { return reinterpret_cast<std::byte*>(this) + bytes; }
+
+    static arena_chunk* create(std::size_t bytes) {
+        void* memory = ::operator new(bytes, std::align_val_t{cacheline_size});
+        arena_chunk* chunk = ::new (memory) arena_chunk;
+        chunk->bytes = bytes;
+        return chunk;
+    }
+
+    static void destroy(arena_chunk* chunk) noexcept {
+        ::operator delete(static_cast<void*>(chunk), std::align_val_t{cacheline_size});
+    }
+
+    static void destroy_list(arena_chunk* head) noexcept {
+        while (head != nullptr) {
+            arena_chunk* next = head->next;
+            destroy(head);
+            head = next;
+        }
+    }
+};
+
+// the chunks behind one batch's payloads, move only, frees them if it is dropped instead of recycled
+class arena_batch {
+public:
+    arena_batch() = default;
+    explicit arena_batch(arena_chunk* chunks) noexcept : head(chunks) {}
+
+    arena_batch(arena_batch&& other) noexcept : head(std::exchange(other.head, nullptr)) {}
+    arena_batch& operator=(arena_batch&& other) noexcept {
+        if (this != &other) {
+            arena_chunk::destroy_list(head);
+            head = std::exchange(other.head, nullptr);
+        }
+        return *this;
+    }
+
+    arena_batch(const arena_batch&)            = delete;
+    arena_batch& operator=(const arena_batch&) = delete;
+
+    ~arena_batch() { arena_chunk::destroy_list(head); }
+
+    bool empty() const noexcept { return head == nullptr; }
+    arena_chunk* release() noexcept { return std::exchange(head, nullptr); }
+
+private:
+    arena_chunk* head = nullptr;
+};
+
+/*
+Arena:
+    - bump allocation for the many small variable size payloads of one batch, freed all at once instead of one by one
+    - owned by one thread (the stage that builds the batches), allocate() is an align + compare + add on private state
+    - memory comes in chunk_size cacheline aligned chunks, a request that doesn't fit a chunk gets its own oversize chunk
+    - two ways to free a batch:
+        1. reset(): the batch died on the owning thread, every chunk goes straight back to the private free list
+        2. detach(): the batch travels downstream, its chunks go with it as an arena_batch, and the downstream thread hands
+           them back with recycle(), through an spsc_queue of chunk pointers (downstream produces, the owner consumes)
+    - the owner only looks at the recycle queue when its private free list is empty, and takes everything there at once
+    - so once the pipeline has warmed up no chunk is newed or deleted, chunks_allocated() stops moving
+
+    owner thread:      allocate(), make<T>(), reset(), detach()
+    downstream thread: recycle() (exactly one downstream thread, it is the producer of the recycle queue)
+*/
+template <std::size_t chunk_size = 64 * 1024, std::size_t recycle_capacity = 256>
+class arena {
+    static_assert(chunk_size % cacheline_size == 0 && chunk_size >= 2 * cacheline_size);
+
+    using recycle_queue_type = spsc_queue<arena_chunk*, recycle_capacity, true, false>;
+
+    static constexpr std::size_t recycle_batch = 32;
+
+public:
+    arena() : recycled(std::make_unique<recycle_queue_type>()) {}
+
+    arena(const arena&)            = delete;
+    arena& operator=(const arena&) = delete;
+
+    ~arena() {
+        arena_chunk::destroy_list(used_head);
+        arena_chunk::destroy_list(free_head);
+
+        arena_chunk* chunk;
+        while (recycled->try_dequeue(chunk)) arena_chunk::destroy(chunk);
+    }
+
+    // owner side, align must be a power of two
+    void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+        // measured from cursor, aligning up can step past limit when align is bigger than what is left
+        std::byte* aligned = align_up(cursor, align);
+        if (aligned == nullptr || std::size_t(limit - cursor) < std::size_t(aligned - cursor) + bytes) {
+            start_chunk(bytes + align);
+            aligned = align_up(cursor, align);
+        }
+        cursor = aligned + bytes;
+        return aligned;
+    }
+
+    // owner side, payloads are never destroyed one by one, so T must not need a destructor
+    template <class T, class... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is dropped without running destructors...");
+        return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    T* make_array(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is dropped without running destructors...");
+        return ::new (allocate(sizeof(T) * count, alignof(T))) T[count];
+    }
+
+    // owner side, everything allocated since the last reset()/detach() is dead
+    void reset() noexcept {
+        while (used_head != nullptr) {
+            arena_chunk* chunk = used_head;
+            used_head = chunk->next;
+            keep_or_destroy(chunk);
+        }
+        cursor = limit = nullptr;
+    }
+
+    // owner side, hands the current batch's chunks over, the arena starts the next batch in a fresh chunk
+    arena_batch detach() noexcept {
+        arena_batch batch(used_head);
+        used_head = nullptr;
+        cursor = limit = nullptr;
+        return batch;
+    }
+
+    // downstream side, the batch's payloads must no longer be in use, chunks that don't fit in the queue are freed
+    void recycle(arena_batch&& batch) {
+        arena_chunk* chunk = batch.release();
+        arena_chunk* staged[recycle_batch];
+
+        while (chunk != nullptr) {
+            std::size_t count = 0;
+            while (chunk != nullptr && count < recycle_batch) {
+                staged[count++] = chunk;
+                chunk = chunk->next;
+            }
+
+            const std::size_t enqueued = recycled->try_enqueue_bulk(staged, count);
+            for (std::size_t i = enqueued; i < count; ++i) arena_chunk::destroy(staged[i]);
+        }
+    }
+
+    // owner side, how many chunks were ever newed (flat once recycling keeps up)
+    std::size_t chunks_allocated() const noexcept { return allocated; }
+
+private:
+    static std::byte* align_up(std::byte* pointer, std::size_t align) noexcept {
+        if (pointer == nullptr) return nullptr;
+        return reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(pointer) + align - 1) & ~std::uintptr_t(align - 1));
+    }
+
+    void start_chunk(std::size_t min_payload) {
+        arena_chunk* chunk = nullptr;
+
+        if (min_payload > chunk_size - sizeof(arena_chunk)) {
+            const std::size_t bytes = sizeof(arena_chunk) + (min_payload + cacheline_size - 1) / cacheline_size * cacheline_size;
+            chunk = arena_chunk::create(bytes);
+            allocated++;
+        } else {
+            if (free_head == nullptr) refill_free_list();
+            if (free_head != nullptr) {
+                chunk = free_head;
+                free_head = chunk->next;
+            } else {
+                chunk = arena_chunk::create(chunk_size);
+                allocated++;
+            }
+        }
+
+        chunk->next = used_head;
+        used_head   = chunk;
+        cursor      = chunk->payload();
+        limit       = chunk->end();
+    }
+
+    void refill_free_list() {
+        arena_chunk* chunks[recycle_batch];
+        std::size_t count;
+        while ((count = recycled->try_dequeue_bulk(chunks, recycle_batch)) > 0) {
+            for (std::size_t i = 0; i < count; ++i) keep_or_destroy(chunks[i]);
+        }
+    }
+
+    // only standard size chunks are pooled, oversize ones were a one off
+    void keep_or_destroy(arena_chunk* chunk) noexcept {
+        if (chunk->bytes != chunk_size) {
+            arena_chunk::destroy(chunk);
+            return;
+        }
+        chunk->next = free_head;
+        free_head   = chunk;
+    }
+
+    // owner private
+    std::byte*   cursor    = nullptr;
+    std::byte*   limit     = nullptr;
+    arena_chunk* used_head = nullptr;
+    arena_chunk* free_head = nullptr;
+    std::size_t  allocated = 0;
+
+    std::unique_ptr<recycle_queue_type> recycled;
+};
+
+};
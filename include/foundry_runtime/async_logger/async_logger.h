@@ -0,0 +1,333 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+namespace foundry_runtime {
+
+/*
+Async Logger:
+    - hot threads never format anything, a log call is a tsc read, a format id and a memcpy of the raw args into a 64 byte record
+    - every hot thread gets its own spsc_queue of records (log_producer), so there is no shared write on the hot path
+    - a single background thread drains every producer, formats the records and flushes one writev with an iovec per producer
+    - a full queue drops the record and counts it instead of blocking the hot thread
+
+Format ids:
+    - FOUNDRY_LOG wraps the format string in a lambda, so every call site is its own instantiation of log_producer::log
+    - that instantiation registers (format string, decoder for exactly its arg types) once in a function local static
+    - the decoder is what lets the background thread turn the raw arg bytes back into text
+*/
+
+static constexpr std::size_t log_record_size   = 64;
+static constexpr std::size_t log_max_formats   = 4096;
+static constexpr std::size_t log_max_producers = 64;
+
+struct log_record {
+    std::uint64_t timestamp;
+    std::uint32_t format_id;
+    std::uint32_t arg_bytes;
+    unsigned char args[log_record_size - 2 * sizeof(std::uint64_t)];
+};
+
+static_assert(sizeof(log_record) == log_record_size);
+static_assert(std::is_trivially_copyable_v<log_record>);
+
+namespace log_detail {
+
+    template <class Arg>
+    static constexpr bool is_loggable_v = std::is_arithmetic_v<Arg> || std::is_enum_v<Arg> || std::is_pointer_v<Arg>;
+
+    // const char* args are printed as strings, so they must be string literals (or otherwise outlive the background flush)
+    template <class Arg>
+    void append_arg(std::string& out, const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, bool>) {
+            out += arg ? "true" : "false";
+        } else if constexpr (std::is_same_v<Arg, char>) {
+            out += arg;
+        } else if constexpr (std::is_same_v<Arg, const char*> || std::is_same_v<Arg, char*>) {
+            out += arg ? arg : "(null)";
+        } else if constexpr (std::is_pointer_v<Arg>) {
+            char buffer[2 + 2 * sizeof(void*) + 1];
+            std::snprintf(buffer, sizeof(buffer), "%p", static_cast<const void*>(arg));
+            out += buffer;
+        } else if constexpr (std::is_enum_v<Arg>) {
+            append_arg(out, static_cast<std::underlying_type_t<Arg>>(arg));
+        } else if constexpr (std::is_floating_point_v<Arg>) {
+            char buffer[32];
+            const int length = std::snprintf(buffer, sizeof(buffer), "%g", double(arg));
+            out.append(buffer, std::size_t(length));
+        } else {
+            char buffer[24];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), arg);
+            out.append(buffer, result.ptr);
+        }
+    }
+
+    // copies the literal text up to the next "{}", returns the position right after it (or npos when the format ran out)
+    inline std::size_t append_until_placeholder(std::string& out, const char* format, std::size_t position) {
+        const char* placeholder = std::strstr(format + position, "{}");
+        if (!placeholder) {
+            out += format + position;
+            return std::string::npos;
+        }
+        out.append(format + position, placeholder);
+        return std::size_t(placeholder - format) + 2;
+    }
+
+    template <class... Args>
+    void decode(std::string& out, const char* format, const unsigned char* args) {
+        std::size_t position = 0;
+        std::size_t offset   = 0;
+
+        auto decode_one = [&](auto tag) {
+            using Arg = typename decltype(tag)::type;
+            Arg arg;
+            std::memcpy(&arg, args + offset, sizeof(Arg));
+            offset += sizeof(Arg);
+
+            if (position == std::string::npos) return;
+            position = append_until_placeholder(out, format, position);
+            if (position != std::string::npos) append_arg(out, arg);
+        };
+        (decode_one(std::type_identity<Args>{}), ...);
+        (void)decode_one; // a format with no args never calls it
+
+        if (position != std::string::npos) out += format + position;
+    }
+
+    using decode_fn = void (*)(std::string&, const char*, const unsigned char*);
+
+    struct format_entry {
+        const char* format  = nullptr;
+        decode_fn   decoder = nullptr;
+    };
+
+    // ids are handed out once per call site, the entry is published to the background thread through the record's queue
+    class format_registry {
+    public:
+        static format_registry& instance() {
+            static format_registry registry;
+            return registry;
+        }
+
+        std::uint32_t add(const char* format, decode_fn decoder) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == log_max_formats) return 0; // id 0 is the overflow entry, it logs its raw format instead of crashing
+            entries[count] = {format, decoder};
+            return std::uint32_t(count++);
+        }
+
+        const format_entry& get(std::uint32_t id) const noexcept { return entries[id]; }
+
+    private:
+        format_registry() { entries[0] = {"<log format registry full>", nullptr}; }
+
+        std::mutex                                mutex;
+        std::size_t                               count = 1;
+        std::array<format_entry, log_max_formats> entries{};
+    };
+
+};
+
+#define FOUNDRY_LOG(producer, format, ...) \
+    (producer).log([]() noexcept -> const char* { return format; } __VA_OPT__(,) __VA_ARGS__)
+
+template <std::size_t queue_capacity = 4096>
+class async_logger {
+    using QueueType = spsc_queue<log_record, queue_capacity, true, false>;
+
+public:
+    class log_producer {
+    public:
+        // args by value so string literals decay to const char*, they are all small trivially copyable types anyway
+        template <class FormatFn, class... Args>
+        bool log(FormatFn format_fn, Args... args) noexcept {
+            static_assert((log_detail::is_loggable_v<Args> && ...), "log args must be arithmetic, enum or pointer...");
+            static_assert((sizeof(Args) + ... + 0) <= sizeof(log_record::args), "log args don't fit in one record...");
+
+            static const std::uint32_t format_id = log_detail::format_registry::instance().add(format_fn(), &log_detail::decode<Args...>);
+
+            log_record record;
+            record.timestamp = read_tsc();
+            record.format_id = format_id;
+            record.arg_bytes = std::uint32_t((sizeof(Args) + ... + 0));
+
+            std::size_t offset = 0;
+            ((std::memcpy(record.args + offset, &args, sizeof(Args)), offset += sizeof(Args)), ...);
+
+            if (queue->try_enqueue(record)) return true;
+
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::uint64_t dropped_count() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        friend class async_logger;
+
+        std::unique_ptr<QueueType> queue = std::make_unique<QueueType>();
+        std::atomic<std::uint64_t> dropped{0};
+        std::string                pending; // background thread only, formatted text waiting for the next writev
+    };
+
+    explicit async_logger(int out_fd = STDOUT_FILENO, std::size_t flush_bytes = 64 * 1024)
+        : fd(out_fd), flush_threshold(flush_bytes), clock(tsc_clock::calibrate()), start_tsc(read_tsc()) {
+        backend = std::thread([this] { run(); });
+    }
+
+    async_logger(const async_logger&)            = delete;
+    async_logger& operator=(const async_logger&) = delete;
+
+    ~async_logger() {
+        running.store(false, std::memory_order_release);
+        backend.join();
+    }
+
+    // call once per hot thread, off the hot path (takes a lock), the producer lives as long as the logger
+    log_producer& create_producer() {
+        std::lock_guard<std::mutex> lock(producers_mutex);
+
+        const std::size_t index = producer_count.load(std::memory_order_relaxed);
+        if (index == log_max_producers) throw std::length_error("async_logger: too many producers");
+
+        owned_producers.push_back(std::make_unique<log_producer>());
+        producers[index] = owned_producers.back().get();
+        producer_count.store(index + 1, std::memory_order_release);
+
+        return *owned_producers.back();
+    }
+
+private:
+    /*
+    Background loop:
+        1. drain up to drain_budget records from every producer, formatting each into that producer's pending text
+        2. once enough text is pending (or we went idle) flush every producer's pending text with one writev
+        3. sleep a little when idle, on stop keep looping until every queue is empty so nothing logged before stop is lost
+    */
+    void run() {
+        static constexpr std::size_t drain_budget = 256;
+
+        std::size_t pending_bytes = 0;
+        for (;;) {
+            const bool still_running = running.load(std::memory_order_acquire);
+            const std::size_t count  = producer_count.load(std::memory_order_acquire);
+
+            std::size_t drained = 0;
+            log_record record;
+            for (std::size_t i = 0; i < count; ++i) {
+                log_producer& producer = *producers[i];
+                for (std::size_t n = 0; n < drain_budget && producer.queue->try_dequeue(record); ++n) {
+                    const std::size_t before = producer.pending.size();
+                    format_record(producer.pending, record);
+                    pending_bytes += producer.pending.size() - before;
+                    drained++;
+                }
+            }
+
+            if (pending_bytes >= flush_threshold || (drained == 0 && pending_bytes > 0)) {
+                flush(count);
+                pending_bytes = 0;
+            }
+
+            if (drained == 0) {
+                if (!still_running) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+
+    void format_record(std::string& out, const log_record& record) const {
+        const auto nanoseconds = static_cast<std::uint64_t>(clock.to_ns(record.timestamp - start_tsc));
+        log_detail::append_arg(out, nanoseconds);
+        out += ' ';
+
+        const log_detail::format_entry& entry = log_detail::format_registry::instance().get(record.format_id);
+        if (entry.decoder) entry.decoder(out, entry.format, record.args);
+        else out += entry.format;
+
+        out += '\n';
+    }
+
+    void flush(std::size_t count) {
+        std::array<iovec, log_max_producers> iov;
+        std::size_t iov_count = 0;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string& pending = producers[i]->pending;
+            if (pending.empty()) continue;
+            iov[iov_count++] = {pending.data(), pending.size()};
+        }
+
+        write_all(iov.data(), iov_count);
+
+        for (std::size_t i = 0; i < count; ++i) producers[i]->pending.clear();
+    }
+
+    /*
+    writev may stop short (pipes, signals), so keep advancing through the iovecs until all of it is out
+        - EINTR just goes round again, EAGAIN (non blocking fd) waits for the fd to drain first
+        - anything else is a hard error, there is nowhere sensible to report a failed log write so the batch is dropped
+    */
+    void write_all(iovec* iov, std::size_t iov_count) {
+        while (iov_count > 0) {
+            const ssize_t written = ::writev(fd, iov, int(iov_count));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    pollfd writable{fd, POLLOUT, 0};
+                    ::poll(&writable, 1, -1);
+                    continue;
+                }
+                return;
+            }
+
+            std::size_t remaining = std::size_t(written);
+            while (iov_count > 0 && remaining >= iov->iov_len) {
+                remaining -= iov->iov_len;
+                iov++;
+                iov_count--;
+            }
+            if (iov_count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+                iov->iov_len -= remaining;
+            }
+        }
+    }
+
+    int           fd;
+    std::size_t   flush_threshold;
+    tsc_clock     clock;
+    std::uint64_t start_tsc;
+
+    std::mutex                                   producers_mutex;
+    std::vector<std::unique_ptr<log_producer>>   owned_producers;
+    std::array<log_producer*, log_max_producers> producers{};
+    std::atomic<std::size_t>                     producer_count{0};
+
+    std::atomic<bool> running{true};
+    std::thread       backend;
+};
+
+};
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+namespace foundry_runtime {
+
+/*
+Pool Slab:
+    - one contiguous block for every buffer of a pool, carved into cacheline aligned strides
+    - with huge pages asked for (linux), first tries an explicit MAP_HUGETLB mapping, then a normal mapping with
+      MADV_HUGEPAGE so transparent huge pages can back it, huge_pages() says whether the explicit one worked
+    - otherwise (or off linux) it is plain aligned operator new
+    - the memory is touched once up front so the first lap over the pool doesn't pay the page faults
+*/
+class pool_slab {
+public:
+    pool_slab(std::size_t bytes, bool try_huge_pages) : size(bytes) {
+#if defined(__linux__)
+        if (try_huge_pages) {
+            const std::size_t huge_page = std::size_t(2) << 20;
+            const std::size_t huge_size = (size + huge_page - 1) / huge_page * huge_page; // hugetlb munmap wants whole pages
+
+            void* mapped = ::mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (mapped != MAP_FAILED) {
+                memory = static_cast<std::byte*>(mapped);
+                size   = huge_size;
+                source = Source::HugeTlb;
+            } else {
+                mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapped == MAP_FAILED) throw std::bad_alloc();
+                ::madvise(mapped, size, MADV_HUGEPAGE); // advisory, fine if THP is off
+                memory = static_cast<std::byte*>(mapped);
+                source = Source::Mapped;
+            }
+        }
+#else
+        (void)try_huge_pages;
+#endif
+        if (memory == nullptr) {
+            memory = static_cast<std::byte*>(::operator new(size, std::align_val_t{cacheline_size}));
+            source = Source::Heap;
+        }
+
+        for (std::size_t offset = 0; offset < size; offset += 4096) memory[offset] = std::byte{0};
+    }
+
+    pool_slab(const pool_slab&)            = delete;
+    pool_slab& operator=(const pool_slab&) = delete;
+
+    ~pool_slab() {
+#if defined(__linux__)
+        if (source != Source::Heap) {
+            ::munmap(memory, size);
+            return;
+        }
+#endif
+        ::operator delete(memory, std::align_val_t{cacheline_size});
+    }
+
+    std::byte*  data() const noexcept { return memory; }
+    std::size_t bytes() const noexcept { return size; }
+    bool        huge_pages() const noexcept { return source == Source::HugeTlb; }
+
+private:
+    enum class Source { Heap, Mapped, HugeTlb };
+
+    std::byte*  memory = nullptr;
+    std::size_t size;
+    Source      source = Source::Heap;
+};
+
+/*
+Buffer Pool:
+    - num_buffers fixed size buffers for payloads that travel between two threads as pointers
+    - the producer owns the free list: acquire() pops from a plain private stack, no atomics at all
+    - the consumer hands buffers back through a reverse spsc_queue of pointers, staged return_batch at a time and pushed
+      with try_enqueue_bulk, so the whole round trip costs one index release per batch on each side
+    - the producer only looks at the return queue when its free list runs dry, and takes everything there in one go
+    - the return queue holds more than num_buffers pointers, so a release can never find it full
+
+    producer side: acquire()
+    consumer side: release(), flush_returns() (call when going idle, or the last partial batch sits in staging)
+*/
+template <std::size_t buffer_size, std::size_t num_buffers, std::size_t return_batch = 32>
+class buffer_pool {
+    static_assert(buffer_size >= 1 && num_buffers >= 1);
+    static_assert(return_batch >= 1 && return_batch <= num_buffers);
+
+    static constexpr std::size_t return_capacity = [] {
+        std::size_t capacity = 2;
+        while (capacity <= num_buffers) capacity <<= 1;
+        return capacity;
+    }();
+
+    using return_queue_type = spsc_queue<std::byte*, return_capacity, true, false>;
+
+    // producer private, on its own line: popping a buffer must not invalidate the slab bounds the consumer reads in owns()
+    struct alignas(cacheline_size) ProducerFreeList {
+        std::unique_ptr<std::byte*[]> items;
+        std::size_t                   count = 0;
+    };
+
+    struct alignas(cacheline_size) ConsumerStaging {
+        std::size_t count = 0;
+        std::byte*  items[return_batch];
+    };
+
+public:
+    static constexpr std::size_t stride = (buffer_size + cacheline_size - 1) / cacheline_size * cacheline_size;
+
+    explicit buffer_pool(bool try_huge_pages = false)
+        : slab(stride * num_buffers, try_huge_pages),
+          returns(std::make_unique<return_queue_type>()),
+          free_list{std::make_unique<std::byte*[]>(num_buffers), num_buffers} {
+        for (std::size_t i = 0; i < num_buffers; ++i) free_list.items[i] = slab.data() + (num_buffers - 1 - i) * stride; // lowest address on top
+    }
+
+    buffer_pool(const buffer_pool&)            = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    ~buffer_pool() = default;
+
+    // producer side, nullptr when every buffer is out (or still sitting in the consumer's staging batch)
+    std::byte* acquire() {
+        if (free_list.count == 0) {
+            free_list.count = returns->try_dequeue_bulk(free_list.items.get(), num_buffers);
+            if (free_list.count == 0) return nullptr;
+        }
+        return free_list.items[--free_list.count];
+    }
+
+    // consumer side, buffer must have come from this pool's acquire()
+    void release(std::byte* buffer) {
+        staging.items[staging.count++] = buffer;
+        if (staging.count == return_batch) flush_returns();
+    }
+
+    // consumer side, pushes a partial return batch
+    void flush_returns() {
+        if (staging.count == 0) return;
+        returns->try_enqueue_bulk(staging.items, staging.count); // always fits, see return_capacity
+        staging.count = 0;
+    }
+
+    bool owns(const std::byte* buffer) const noexcept {
+        return buffer >= slab.data() && buffer < slab.data() + stride * num_buffers && std::size_t(buffer - slab.data()) % stride == 0;
+    }
+
+    bool huge_pages() const noexcept { return slab.huge_pages(); }
+
+    static constexpr std::size_t size() noexcept { return num_buffers; }
+
+private:
+    // read only after construction, shared by both sides
+    pool_slab                          slab;
+    std::unique_ptr<return_queue_type> returns;
+
+    ProducerFreeList free_list;
+    ConsumerStaging  staging{};
+};
+
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+Conflating Channel:
+    - single producer / single (or many, reads never write) consumer "latest value" slot, built on per-slot seqlocks
+    - the producer never blocks and never fails, publishing just overwrites the oldest slot
+    - the consumer always gets the newest fully written value, stale values are simply never seen
+    - with num_slots > 1 the producer round robins, so a reader copying version v is only torn if the producer laps all the slots
+
+Sequence words:
+    - slot sequence is 2 * version when stable, odd while the producer is writing it
+    - a reader copies between two sequence loads, if they differ (or the first was odd) the copy may be torn and it retries
+    - each slot (and its sequence word) starts on its own cacheline, latest sits alone on the producer's line
+*/
+template <class T, std::size_t num_slots = 1>
+class conflating_channel {
+    static_assert(num_slots >= 1);
+    static_assert(std::is_trivially_copyable_v<T>, "Trivially Copyable T NOT Provided...");
+
+    struct alignas(cacheline_size) Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        T data;
+    };
+
+    struct alignas(cacheline_size) PaddedVersion {
+        std::atomic<std::uint64_t> version{0};
+    };
+
+public:
+    conflating_channel()                                     = default;
+    conflating_channel(const conflating_channel&)            = delete;
+    conflating_channel& operator=(const conflating_channel&) = delete;
+
+    ~conflating_channel() = default;
+
+    void publish(const T& in_data) noexcept {
+        const std::uint64_t version = latest.version.load(std::memory_order_relaxed) + 1;
+        Slot& slot = slots[slot_index(version)];
+
+        // the fence keeps the data stores from being reordered above the odd sequence store
+        slot.sequence.store(2 * version - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&slot.data, &in_data, sizeof(T));
+
+        slot.sequence.store(2 * version, std::memory_order_release);
+        latest.version.store(version, std::memory_order_release);
+    }
+
+    // copies the newest consistent value into out_data, returns its version (0 means nothing was ever published and out_data is untouched)
+    std::uint64_t read(T& out_data) const noexcept {
+        for (;;) {
+            const std::uint64_t version = latest.version.load(std::memory_order_acquire);
+            if (version == 0) return 0;
+
+            const Slot& slot = slots[slot_index(version)];
+
+            const std::uint64_t sequence_before = slot.sequence.load(std::memory_order_acquire);
+            if (sequence_before & 1) {
+                cpu_relax();
+                continue;
+            }
+
+            // racy copy by design, the sequence check below throws it away if the producer touched the slot meanwhile
+            std::memcpy(&out_data, &slot.data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence_before) return sequence_before / 2;
+
+            cpu_relax();
+        }
+    }
+
+    // only copies when something newer than last_version was published, last_version is updated on success
+    bool read_if_newer(T& out_data, std::uint64_t& last_version) const noexcept {
+        if (latest.version.load(std::memory_order_acquire) <= last_version) return false;
+
+        const std::uint64_t version = read(out_data);
+        if (version <= last_version) return false;
+
+        last_version = version;
+        return true;
+    }
+
+    std::uint64_t latest_version() const noexcept { return latest.version.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t slot_index(std::uint64_t version) noexcept { return std::size_t((version - 1) % num_slots); }
+
+    PaddedVersion latest{};
+
+    Slot slots[num_slots];
+};
+
+};
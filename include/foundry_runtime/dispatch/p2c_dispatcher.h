@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+namespace foundry_runtime {
+
+/*
+Power Of Two Choices Dispatcher:
+    - one producer, num_workers worker queues, for stateless work where any worker can take any item
+    - each dispatch samples two distinct queues at random and enqueues to the emptier one, so the load imbalance stays
+      around log log n instead of the log n of picking one at random, without scanning every queue
+    - occupancy comes from spsc_queue::producer_occupancy(): the producer's own write index against its cached read index
+        - no shared writes, and no shared reads at all while the cached answer is at most refresh_above
+        - the cached answer is an upper bound, so only a sample that looks busy is refreshed (one load of read_next)
+    - if the emptier queue is full anyway the other one is tried, dispatch() only fails when both samples are full
+*/
+template <
+    class T,
+    std::size_t num_workers,
+    std::size_t queue_capacity = 1024,
+    std::size_t refresh_above  = queue_capacity / 16
+>
+class p2c_dispatcher {
+    static_assert(num_workers >= 2, "two choices needs at least two workers...");
+
+public:
+    using queue_type = spsc_queue<T, queue_capacity, true, false>;
+
+    explicit p2c_dispatcher(std::uint64_t seed = 0x9e3779b97f4a7c15ull) : rng_state(seed ? seed : 1) {
+        for (auto& queue : queues) queue = std::make_unique<queue_type>();
+    }
+
+    p2c_dispatcher(const p2c_dispatcher&)            = delete;
+    p2c_dispatcher& operator=(const p2c_dispatcher&) = delete;
+
+    ~p2c_dispatcher() = default;
+
+    // producer side, false means both sampled queues were full (nothing was enqueued)
+    bool dispatch(const T& item) {
+        const std::uint64_t random = next_random();
+        const std::size_t first  = std::size_t(random % num_workers);
+        const std::size_t second = (first + 1 + std::size_t((random >> 32) % (num_workers - 1))) % num_workers;
+
+        const std::size_t first_load  = occupancy_of(first);
+        const std::size_t second_load = occupancy_of(second);
+
+        const std::size_t preferred = second_load < first_load ? second : first;
+        const std::size_t fallback  = preferred == first ? second : first;
+
+        if (queues[preferred]->try_enqueue(item)) {
+            last_choice = preferred;
+            return true;
+        }
+        if (queues[fallback]->try_enqueue(item)) {
+            last_choice = fallback;
+            return true;
+        }
+        return false;
+    }
+
+    // producer side, the worker the last successful dispatch() went to
+    std::size_t last_worker() const noexcept { return last_choice; }
+
+    // consumer side, worker `worker` dequeues (or bulk dequeues) from here
+    queue_type& worker_queue(std::size_t worker) noexcept { return *queues[worker]; }
+
+    // any thread, a snapshot of the shared indices
+    std::size_t queued(std::size_t worker) const noexcept { return queues[worker]->size_approx(); }
+
+private:
+    std::size_t occupancy_of(std::size_t worker) {
+        const std::size_t cached = queues[worker]->producer_occupancy();
+        return cached <= refresh_above ? cached : queues[worker]->refresh_producer_occupancy();
+    }
+
+    // xorshift64*, producer private, nothing here needs to be better than "not correlated with the queues"
+    std::uint64_t next_random() noexcept {
+        rng_state ^= rng_state >> 12;
+        rng_state ^= rng_state << 25;
+        rng_state ^= rng_state >> 27;
+        return rng_state * 0x2545f4914f6cdd1dull;
+    }
+
+    std::array<std::unique_ptr<queue_type>, num_workers> queues;
+    std::uint64_t rng_state;
+    std::size_t   last_choice = 0;
+};
+
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+namespace foundry_runtime {
+
+/*
+Sharded Dispatcher:
+    - one producer fans out to num_shards workers, each worker owns exactly one spsc_queue (so SPSC holds per shard)
+    - the shard is hash(key(item)) % num_shards, so every item for a key lands on the same worker, in order
+    - items are staged per shard in producer private batches and pushed with try_enqueue_bulk, one index release per batch
+    - backpressure is per shard: a full shard only fills up its own staging batch, every other shard keeps flowing
+        - dispatch() only returns false when that shard's queue AND its staging batch are both full
+*/
+template <
+    class T,
+    std::size_t num_shards,
+    class KeyFn,
+    class HashFn               = std::hash<std::decay_t<std::invoke_result_t<KeyFn, const T&>>>,
+    std::size_t queue_capacity = 1024,
+    std::size_t batch_size     = 32
+>
+class sharded_dispatcher {
+    static_assert(num_shards >= 1);
+    static_assert(batch_size >= 1 && batch_size < queue_capacity);
+
+    // producer private, each shard's batch on its own lines so flushing one shard doesn't drag the others' batches in
+    struct alignas(cacheline_size) StagingBatch {
+        std::size_t count = 0;
+        T items[batch_size];
+    };
+
+public:
+    using queue_type = spsc_queue<T, queue_capacity, true, false>;
+
+    explicit sharded_dispatcher(KeyFn key_fn = KeyFn{}, HashFn hash_fn = HashFn{})
+        : key(std::move(key_fn)), hash(std::move(hash_fn)) {
+        for (auto& queue : queues) queue = std::make_unique<queue_type>();
+    }
+
+    sharded_dispatcher(const sharded_dispatcher&)            = delete;
+    sharded_dispatcher& operator=(const sharded_dispatcher&) = delete;
+
+    ~sharded_dispatcher() = default;
+
+    std::size_t shard_of(const T& item) const { return std::size_t(hash(key(item))) % num_shards; }
+
+    // producer side, false means this item's shard is fully backed up (nothing was staged)
+    bool dispatch(const T& item) {
+        const std::size_t shard = shard_of(item);
+        StagingBatch& batch = staging[shard];
+
+        if (batch.count == batch_size) {
+            flush_shard(shard);
+            if (batch.count == batch_size) return false; // the queue took none of it, a partial flush still makes room
+        }
+
+        batch.items[batch.count++] = item;
+        if (batch.count == batch_size) flush_shard(shard);
+
+        return true;
+    }
+
+    // producer side, pushes every partial batch (call when the input goes quiet), returns how many items are still staged
+    std::size_t flush() {
+        std::size_t still_staged = 0;
+        for (std::size_t shard = 0; shard < num_shards; ++shard) {
+            if (staging[shard].count) flush_shard(shard);
+            still_staged += staging[shard].count;
+        }
+        return still_staged;
+    }
+
+    // consumer side, worker `shard` dequeues (or bulk dequeues) from here
+    queue_type& shard_queue(std::size_t shard) noexcept { return *queues[shard]; }
+
+    // any thread for the queued part, staged is producer private so only the producer should ask for it
+    std::size_t queued(std::size_t shard) const noexcept { return queues[shard]->size_approx(); }
+    std::size_t staged(std::size_t shard) const noexcept { return staging[shard].count; }
+    std::size_t occupancy(std::size_t shard) const noexcept { return queued(shard) + staged(shard); }
+
+private:
+    // true when the whole batch went out, otherwise the leftovers are shifted to the front and wait for the next try
+    bool flush_shard(std::size_t shard) {
+        StagingBatch& batch = staging[shard];
+
+        const std::size_t enqueued = queues[shard]->try_enqueue_bulk(batch.items, batch.count);
+        if (enqueued == batch.count) {
+            batch.count = 0;
+            return true;
+        }
+
+        std::memmove(batch.items, batch.items + enqueued, (batch.count - enqueued) * sizeof(T));
+        batch.count -= enqueued;
+        return false;
+    }
+
+    KeyFn  key;
+    HashFn hash;
+
+    std::array<StagingBatch, num_shards>                staging{};
+    std::array<std::unique_ptr<queue_type>, num_shards> queues;
+};
+
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#if defined(__cpp_lib_hardware_interference_size)
+    static constexpr std::size_t cacheline_size = std::hardware_destructive_interference_size;
+#elif defined(__APPLE__) && defined(__aarch64__)
+    static constexpr std::size_t cacheline_size = 128;
+#else   
+    static constexpr std::size_t cacheline_size = 64;
+#endif
+
+namespace foundry_runtime {
+
+static inline void sw_prefetch_read(const void* p) noexcept {
+    __builtin_prefetch(p, 0, 3);
+}
+
+static inline void sw_prefetch_write(const void* p) noexcept {
+    __builtin_prefetch(p, 1, 3);
+}
+
+static inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+};
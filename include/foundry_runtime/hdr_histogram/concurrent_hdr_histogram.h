@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <foundry_runtime/hdr_histogram/hdr_histogram.h>
+
+namespace foundry_runtime {
+
+/*
+Concurrent HDR histogram (single writer, any number of readers):
+    - same log-linear buckets as hdr_histogram, but every count is an atomic so a monitor thread can read while the
+      writer keeps recording, nothing ever locks or waits
+    - the writer is the only one storing, so a record is a relaxed load + store per field (no locked RMW), same trick
+      as spsc_counting_stats
+    - snapshot() copies the counts into a plain hdr_histogram for percentiles, it may be a few records behind the
+      writer and min/max may be a record ahead of the counts, both fine for alarming on a tail
+    - inline storage (no heap), so it can sit inside a queue
+*/
+template <std::size_t sub_bucket_bits = 5>
+class concurrent_hdr_histogram {
+    using plain_type = hdr_histogram<sub_bucket_bits>;
+
+    static constexpr std::size_t bucket_count = plain_type::bucket_count;
+
+public:
+    // writer thread only
+    void record(std::uint64_t value) noexcept {
+        bump(counts[plain_type::bucket_index(value)]);
+        if (value < min_value.load(std::memory_order_relaxed)) min_value.store(value, std::memory_order_relaxed);
+        if (value > max_value.load(std::memory_order_relaxed)) max_value.store(value, std::memory_order_relaxed);
+    }
+
+    // any thread
+    plain_type snapshot() const {
+        plain_type out;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            const std::uint64_t count = counts[i].load(std::memory_order_relaxed);
+            out.counts[i] = count;
+            out.total    += count;
+        }
+        out.min_value = min_value.load(std::memory_order_relaxed);
+        out.max_value = max_value.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    std::uint64_t count() const noexcept {
+        std::uint64_t total = 0;
+        for (const auto& count : counts) total += count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    static void bump(std::atomic<std::uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, bucket_count> counts{};
+    std::atomic<std::uint64_t> min_value{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_value{0};
+};
+
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace foundry_runtime {
+
+/*
+Log-linear (HDR style) histogram:
+    - every power of two range is split into 2^sub_bucket_bits linear sub buckets
+    - values below 2^(sub_bucket_bits + 1) are recorded exactly
+    - anything above is recorded with a relative error of at most 1 / 2^sub_bucket_bits
+    - recording is a clz, a shift and an increment, so it is cheap enough to sit in a latency loop
+*/
+template <std::size_t sub_bucket_bits = 5>
+class hdr_histogram {
+    static_assert(sub_bucket_bits >= 1 && sub_bucket_bits < 32);
+
+    static constexpr std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t bucket_count     = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+public:
+    hdr_histogram() : counts(bucket_count, 0) {}
+
+    void record(std::uint64_t value) noexcept {
+        counts[bucket_index(value)]++;
+        total++;
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+    }
+
+    void merge(const hdr_histogram& other) noexcept {
+        for (std::size_t i = 0; i < bucket_count; i++) counts[i] += other.counts[i];
+        total    += other.total;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    void reset() noexcept {
+        std::fill(counts.begin(), counts.end(), 0);
+        total     = 0;
+        min_value = std::numeric_limits<std::uint64_t>::max();
+        max_value = 0;
+    }
+
+    std::uint64_t count() const noexcept { return total; }
+    std::uint64_t min()   const noexcept { return total ? min_value : 0; }
+    std::uint64_t max()   const noexcept { return max_value; }
+
+    // returns the highest value of the bucket holding the requested percentile (clamped to the observed max)
+    std::uint64_t value_at_percentile(double percentile) const noexcept {
+        if (total == 0) return 0;
+
+        auto target = static_cast<std::uint64_t>((percentile / 100.0) * double(total) + 0.5);
+        target = std::clamp<std::uint64_t>(target, 1, total);
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; i++) {
+            seen += counts[i];
+            if (seen >= target) return std::min(bucket_highest_value(i), max_value);
+        }
+        return max_value;
+    }
+
+private:
+    template <std::size_t> friend class concurrent_hdr_histogram;
+
+    static std::size_t bucket_index(std::uint64_t value) noexcept {
+        const std::size_t msb   = 63 - std::size_t(__builtin_clzll(value | 1));
+        const std::size_t shift = msb > sub_bucket_bits ? msb - sub_bucket_bits : 0;
+        return (shift << sub_bucket_bits) + std::size_t(value >> shift);
+    }
+
+    static std::uint64_t bucket_highest_value(std::size_t index) noexcept {
+        if (index < 2 * sub_bucket_count) return index;
+
+        const std::size_t   shift    = (index >> sub_bucket_bits) - 1;
+        const std::uint64_t mantissa = index - (shift << sub_bucket_bits);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total     = 0;
+    std::uint64_t min_value = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_value = 0;
+};
+
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace foundry_runtime {
+
+/*
+Inline Function:
+    - fixed capacity, never allocating function object meant to be shipped between threads through spsc_queue
+    - the callable is constructed straight into inline storage, next to it sits one plain invoker function pointer
+    - the callable has to be trivially copyable (lambdas capturing ints, pointers, trivially copyable structs...)
+        - that is what makes the whole inline_function trivially copyable, so the ring can memcpy it around
+        - and since nothing needs destroying there is no manager pointer, one invoker pointer is all the type erasure
+    - too big / over aligned / non trivially copyable callables fail at compile time, never at runtime
+    - calling an empty (default constructed) inline_function aborts: the invoker starts out pointing at a trap rather
+      than null, so the call stays one indirect jump with no branch and a stray call is a clean crash, not UB
+*/
+template <class Signature, std::size_t storage_size = 56>
+class inline_function;
+
+template <class R, class... Args, std::size_t storage_size>
+class inline_function<R(Args...), storage_size> {
+    using invoker_fn = R (*)(void*, Args...);
+
+    // pointer alignment (not max_align_t) so 56 bytes of storage + the invoker is exactly 64 bytes
+    static constexpr std::size_t storage_align = alignof(void*);
+
+    template <class F>
+    static R invoke(void* storage, Args... args) {
+        return (*std::launder(static_cast<F*>(storage)))(std::forward<Args>(args)...);
+    }
+
+    [[noreturn]] static R trap(void*, Args...) { std::abort(); }
+
+public:
+    inline_function() = default;
+
+    template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, inline_function>>>
+    inline_function(F&& callable) noexcept {
+        using Callable = std::decay_t<F>;
+
+        static_assert(sizeof(Callable) <= storage_size,  "callable captures too much for inline_function storage...");
+        static_assert(alignof(Callable) <= storage_align, "callable is over aligned for inline_function storage...");
+        static_assert(std::is_trivially_copyable_v<Callable>, "callable must be trivially copyable to ship through spsc_queue...");
+        static_assert(std::is_invocable_r_v<R, Callable&, Args...>, "callable does not match the inline_function signature...");
+
+        ::new (static_cast<void*>(storage)) Callable(std::forward<F>(callable));
+        invoker = &invoke<Callable>;
+    }
+
+    R operator()(Args... args) { return invoker(storage, std::forward<Args>(args)...); }
+
+    explicit operator bool() const noexcept { return invoker != &trap; }
+
+private:
+    alignas(storage_align) unsigned char storage[storage_size];
+    invoker_fn invoker = &trap;
+};
+
+static_assert(sizeof(inline_function<void()>) == 64, "default inline_function should be exactly one 64 byte slot...");
+static_assert(std::is_trivially_copyable_v<inline_function<void()>>);
+
+// producer side, false when the queue is full (nothing allocated, nothing to clean up)
+template <class QueueType, class F>
+bool submit_to(QueueType& queue, F&& task) {
+    return queue.try_enqueue(typename QueueType::value_type(std::forward<F>(task)));
+}
+
+// consumer side, runs up to max_tasks queued tasks and returns how many ran
+template <class QueueType>
+std::size_t run_tasks(QueueType& queue, std::size_t max_tasks) {
+    typename QueueType::value_type task;
+    std::size_t ran = 0;
+    while (ran < max_tasks && queue.try_dequeue(task)) {
+        task();
+        ran++;
+    }
+    return ran;
+}
+
+};
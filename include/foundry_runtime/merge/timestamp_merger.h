@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+Timestamp Merger:
+    - fan in of num_inputs spsc queues (each already in timestamp order) into one globally timestamp ordered stream
+    - each input is peeked through a small consumer private buffer filled with try_dequeue_bulk, so the queue indices
+      are touched once per batch_size elements instead of once per element
+    - the heads are kept in a loser tree, so picking the next element costs log2(num_inputs) compares, not num_inputs
+
+Empty inputs + watermarks:
+    - an input's watermark is the last timestamp it produced, anything it sends later is >= that
+    - an empty input blocks the merge at its watermark (nothing newer than it can be emitted, it might still send older)
+    - once the newest timestamp seen on any input is more than `lateness` past its watermark, the input counts as idle and
+      is skipped, if it does send something older later it is emitted late and counted in late_count()
+    - lateness = max() means never skip, strict ordering at the cost of stalling on a silent feed
+*/
+template <class QueueType, std::size_t num_inputs, class TimestampFn, std::size_t batch_size = 32>
+class timestamp_merger {
+    static_assert(num_inputs >= 1);
+    static_assert(batch_size >= 1);
+
+    using T = typename QueueType::value_type;
+
+    static constexpr std::size_t leaf_count = [] {
+        std::size_t leaves = 1;
+        while (leaves < num_inputs) leaves <<= 1;
+        return leaves;
+    }();
+
+    static constexpr std::uint64_t never = std::numeric_limits<std::uint64_t>::max();
+
+    struct alignas(cacheline_size) InputBuffer {
+        T             items[batch_size];
+        std::size_t   head      = 0;
+        std::size_t   count     = 0;
+        std::uint64_t watermark = 0;
+        bool          skipped   = false; // frozen for the duration of one poll so the tree stays consistent
+    };
+
+    // ready elements sort before a blocked input at the same timestamp, equal timestamps are never reordered past each other anyway
+    struct Key {
+        std::uint64_t timestamp;
+        bool          blocking;
+
+        bool operator<(const Key& other) const noexcept {
+            return timestamp != other.timestamp ? timestamp < other.timestamp : (!blocking && other.blocking);
+        }
+    };
+
+public:
+    timestamp_merger(std::array<QueueType*, num_inputs> input_queues, std::uint64_t lateness_bound, TimestampFn timestamp_fn = TimestampFn{})
+        : inputs(input_queues), lateness(lateness_bound), timestamp(std::move(timestamp_fn)) {}
+
+    timestamp_merger(const timestamp_merger&)            = delete;
+    timestamp_merger& operator=(const timestamp_merger&) = delete;
+
+    /*
+    poll:
+        1. refill every empty input buffer (one bulk dequeue each), then decide which empty inputs are idle for this poll
+        2. build the loser tree over the heads
+        3. emit the winner while it is a real element, refilling that one input's buffer when it runs dry
+        4. stop at max_emit, or when the winner is a blocking (empty, not idle) input, or when everything is empty
+    */
+    template <class Emit>
+    std::size_t poll(Emit&& emit, std::size_t max_emit = std::numeric_limits<std::size_t>::max()) {
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            if (buffers[i].head == buffers[i].count) refill(i);
+        }
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            InputBuffer& buffer = buffers[i];
+            buffer.skipped = buffer.head == buffer.count && newest_seen - buffer.watermark > lateness; // newest_seen >= every watermark
+        }
+
+        build_tree();
+
+        std::size_t emitted = 0;
+        while (emitted < max_emit) {
+            const std::size_t winner = tree[0];
+            const Key winner_key = key_of(winner);
+            if (winner_key.blocking || winner_key.timestamp == never) break;
+
+            InputBuffer& buffer = buffers[winner];
+            const T& element = buffer.items[buffer.head];
+
+            const std::uint64_t element_timestamp = timestamp(element);
+            late += element_timestamp < last_emitted;
+            last_emitted = element_timestamp > last_emitted ? element_timestamp : last_emitted;
+
+            emit(element);
+            emitted++;
+
+            if (++buffer.head == buffer.count) refill(winner);
+            replay(winner);
+        }
+
+        return emitted;
+    }
+
+    // elements emitted with an older timestamp than something already emitted (only possible after skipping an idle input)
+    std::uint64_t late_count() const noexcept { return late; }
+
+private:
+    void refill(std::size_t input) {
+        InputBuffer& buffer = buffers[input];
+        buffer.head  = 0;
+        buffer.count = inputs[input]->try_dequeue_bulk(buffer.items, batch_size);
+        if (buffer.count == 0) return;
+
+        // inputs are in order, so the last element of the batch is the new watermark
+        buffer.watermark = timestamp(buffer.items[buffer.count - 1]);
+        if (buffer.watermark > newest_seen) newest_seen = buffer.watermark;
+
+        buffer.skipped = false;
+    }
+
+    Key key_of(std::size_t leaf) const noexcept {
+        if (leaf >= num_inputs) return {never, false};
+
+        const InputBuffer& buffer = buffers[leaf];
+        if (buffer.head != buffer.count) return {timestamp(buffer.items[buffer.head]), false};
+        if (buffer.skipped) return {never, false};
+        return {buffer.watermark, true};
+    }
+
+    // tree[1..leaf_count) hold the loser of each match, tree[0] the overall winner, leaves are leaf_count + input
+    void build_tree() {
+        std::array<std::size_t, 2 * leaf_count> winners{};
+        for (std::size_t leaf = 0; leaf < leaf_count; ++leaf) winners[leaf_count + leaf] = leaf;
+
+        for (std::size_t node = leaf_count - 1; node >= 1; --node) {
+            const std::size_t left  = winners[2 * node];
+            const std::size_t right = winners[2 * node + 1];
+            const bool left_wins = !(key_of(right) < key_of(left));
+
+            winners[node] = left_wins ? left : right;
+            tree[node]    = left_wins ? right : left;
+        }
+        tree[0] = winners[1];
+    }
+
+    // only the path from the changed leaf to the root can change, play the new key against the stored losers
+    void replay(std::size_t leaf) {
+        std::size_t winner = leaf;
+        Key winner_key = key_of(winner);
+
+        for (std::size_t node = (leaf_count + leaf) / 2; node >= 1; node /= 2) {
+            const Key loser_key = key_of(tree[node]);
+            if (loser_key < winner_key) {
+                std::swap(tree[node], winner);
+                winner_key = loser_key;
+            }
+        }
+        tree[0] = winner;
+    }
+
+    std::array<QueueType*, num_inputs> inputs;
+    std::uint64_t                      lateness;
+    TimestampFn                        timestamp;
+
+    std::array<InputBuffer, num_inputs> buffers{};
+    std::array<std::size_t, leaf_count> tree{};
+
+    std::uint64_t newest_seen  = 0;
+    std::uint64_t last_emitted = 0;
+    std::uint64_t late         = 0;
+};
+
+};
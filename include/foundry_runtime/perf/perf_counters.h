@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace foundry_runtime {
+
+// what perf_counters tries to open, c2c_hitm is only opened when a raw encoding is given (it is model specific)
+enum class perf_event_kind : std::size_t {
+    cycles,
+    instructions,
+    l1d_read_misses,
+    llc_misses,
+    c2c_hitm,
+    context_switches,
+    count
+};
+
+static constexpr std::size_t perf_event_count = std::size_t(perf_event_kind::count);
+
+static constexpr const char* perf_event_name(perf_event_kind kind) noexcept {
+    constexpr const char* names[perf_event_count] = {"cycles", "instructions", "l1d_read_misses", "llc_misses", "c2c_hitm", "context_switches"};
+    return names[std::size_t(kind)];
+}
+
+/*
+Reading:
+    - one value per event, already scaled by time_enabled / time_running when the kernel had to multiplex the pmu
+    - valid[] is false for an event that never opened (or never got scheduled), per_op() then returns -1 so a report
+      can print "n/a" instead of a zero that looks like a measurement
+*/
+struct perf_reading {
+    std::uint64_t value[perf_event_count]{};
+    bool          valid[perf_event_count]{};
+
+    bool has(perf_event_kind kind) const noexcept { return valid[std::size_t(kind)]; }
+
+    std::uint64_t operator[](perf_event_kind kind) const noexcept { return value[std::size_t(kind)]; }
+
+    double per_op(perf_event_kind kind, std::uint64_t operations) const noexcept {
+        if (!has(kind) || operations == 0) return -1.0;
+        return double(value[std::size_t(kind)]) / double(operations);
+    }
+
+    // instructions per cycle, -1 unless both were counted
+    double ipc() const noexcept {
+        if (!has(perf_event_kind::cycles) || !has(perf_event_kind::instructions) || value[std::size_t(perf_event_kind::cycles)] == 0) return -1.0;
+        return double(value[std::size_t(perf_event_kind::instructions)]) / double(value[std::size_t(perf_event_kind::cycles)]);
+    }
+};
+
+/*
+Perf Counters:
+    - perf_event_open counters around a benchmark run: cycles, instructions, L1D read misses, LLC misses, context
+      switches, and cache to cache (HITM / snoop) transfers when given the raw event for this cpu, e.g. 0x04d2
+      (MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM) on intel skylake and later
+    - counts the calling thread and every thread it starts after construction (inherit), so construct it on the
+      thread that spawns the producer and consumer, before spawning them
+        - each event is its own fd rather than a group, the kernel can't read inherited groups, the cost is that events
+          may be multiplexed onto the pmu at slightly different times (values are scaled, see perf_reading)
+    - an event that fails to open is just left out: containers and VMs often have no pmu (ENOENT), seccomp or
+      perf_event_paranoid can refuse everything (EACCES/EPERM), and off linux nothing opens at all
+        - available() says whether anything opened, first_error() keeps the errno of the first failure for the report
+    - start()/stop() are ioctls on each fd, a handful of syscalls, so bracket whole runs, not single operations
+*/
+class perf_counters {
+public:
+    explicit perf_counters(std::uint64_t c2c_raw_config = 0) noexcept {
+#if defined(__linux__)
+        open_event(perf_event_kind::cycles,           PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_event(perf_event_kind::instructions,     PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_event(perf_event_kind::l1d_read_misses,  PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        open_event(perf_event_kind::llc_misses,       PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open_event(perf_event_kind::context_switches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+        if (c2c_raw_config) open_event(perf_event_kind::c2c_hitm, PERF_TYPE_RAW, c2c_raw_config);
+#else
+        (void)c2c_raw_config;
+        error = ENOSYS;
+#endif
+    }
+
+    perf_counters(const perf_counters&)            = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters() {
+#if defined(__linux__)
+        for (const int fd : fds) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    bool available() const noexcept {
+        for (const int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    bool opened(perf_event_kind kind) const noexcept { return fds[std::size_t(kind)] >= 0; }
+
+    // errno of the first event that failed to open, 0 if none did
+    int first_error() const noexcept { return error; }
+
+    void start() noexcept {
+#if defined(__linux__)
+        for (const int fd : fds) {
+            if (fd < 0) continue;
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    perf_reading stop() noexcept {
+        perf_reading reading;
+#if defined(__linux__)
+        for (std::size_t i = 0; i < perf_event_count; ++i) {
+            if (fds[i] >= 0) ::ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+
+        for (std::size_t i = 0; i < perf_event_count; ++i) {
+            if (fds[i] < 0) continue;
+
+            // read_format TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING
+            std::uint64_t raw[3] = {};
+            if (::read(fds[i], raw, sizeof(raw)) != ssize_t(sizeof(raw)) || raw[2] == 0) continue;
+
+            reading.value[i] = raw[2] == raw[1] ? raw[0] : std::uint64_t(double(raw[0]) * double(raw[1]) / double(raw[2]));
+            reading.valid[i] = true;
+        }
+#endif
+        return reading;
+    }
+
+private:
+#if defined(__linux__)
+    static constexpr std::uint64_t cache_config(std::uint64_t cache, std::uint64_t op, std::uint64_t result) noexcept {
+        return cache | (op << 8) | (result << 16);
+    }
+
+    void open_event(perf_event_kind kind, std::uint32_t type, std::uint64_t config) noexcept {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = type != PERF_TYPE_SOFTWARE; // paranoid=2 only allows user counts, switches happen in the kernel
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0 && !attr.exclude_kernel && (errno == EACCES || errno == EPERM)) {
+            attr.exclude_kernel = 1; // unprivileged, settle for the user side count
+            fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        }
+        if (fd < 0) {
+            if (error == 0) error = errno;
+            return;
+        }
+        fds[std::size_t(kind)] = int(fd);
+    }
+#endif
+
+    int fds[perf_event_count] = {-1, -1, -1, -1, -1, -1};
+    int error = 0;
+};
+
+};
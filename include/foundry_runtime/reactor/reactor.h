@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/inline_function/inline_function.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+
+namespace foundry_runtime {
+
+/*
+Reactor Runtime (thread per core):
+    - one reactor thread per core, pinned, and every reactor owns its shard of data outright
+    - cores only talk through an all to all mesh of spsc_queues of inline_function tasks
+        - mesh[from][to] is only ever written by reactor `from` and only ever read by reactor `to`, so SPSC holds by construction
+        - there is one extra row (from == num_reactors) for the single non reactor thread that drives the runtime
+    - run_on(core, task) picks the queue from the calling thread's identity, no locks anywhere on the path
+    - each reactor's poll loop drains its inbound column with try_dequeue_bulk and runs the tasks in order per sender
+*/
+template <std::size_t queue_capacity = 256, std::size_t poll_batch = 32>
+class reactor_runtime {
+public:
+    using task_type  = inline_function<void()>;
+    using queue_type = spsc_queue<task_type, queue_capacity, true, false>;
+
+    static constexpr std::size_t not_a_reactor = std::numeric_limits<std::size_t>::max();
+
+    /*
+    Pinning:
+        - reactor i is pinned to allowed cpu number (first_cpu + i) % allowed cpus, wrapping so small boxes still run every reactor
+        - the allowed cpus are the constructing thread's affinity mask (sched_getaffinity), so taskset and cgroup cpusets are
+          respected instead of pinning onto cpus the process may not use
+    */
+    explicit reactor_runtime(std::size_t num_reactors, std::size_t first_cpu = 0)
+        : reactor_count(num_reactors), cpu_base(first_cpu), allowed_cpus(affinity_cpus()) {
+        if (num_reactors == 0) throw std::invalid_argument("reactor_runtime: need at least one reactor");
+
+        mesh.reserve((num_reactors + 1) * num_reactors);
+        for (std::size_t i = 0; i < (num_reactors + 1) * num_reactors; ++i) mesh.push_back(std::make_unique<queue_type>());
+    }
+
+    reactor_runtime(const reactor_runtime&)            = delete;
+    reactor_runtime& operator=(const reactor_runtime&) = delete;
+
+    ~reactor_runtime() { stop(); }
+
+    // a second start() while running is a no-op, a second set of reactors would break the single consumer rule
+    void start() {
+        if (started) return;
+        started = true;
+
+        running.store(true, std::memory_order_release);
+        for (std::size_t core = 0; core < reactor_count; ++core) {
+            threads.emplace_back([this, core] { run_reactor(core); });
+        }
+    }
+
+    // reactors keep polling until a full sweep of their inbound queues comes back empty, then exit
+    // (quiesce cross core traffic first, a task posted to a reactor that already exited is never run)
+    void stop() {
+        running.store(false, std::memory_order_release);
+        for (auto& thread : threads) thread.join();
+        threads.clear();
+        started = false;
+    }
+
+    /*
+    run_on:
+        - from a reactor thread it uses mesh[that reactor][core]
+        - from anywhere else it uses the external row, so only ONE non reactor thread may call it (it is a single producer)
+        - false means that queue is full, the caller decides whether to retry, drop or run something else first
+    */
+    template <class F>
+    bool run_on(std::size_t core, F&& task) {
+        const std::size_t from = current_runtime == this ? current_core : reactor_count;
+        return submit_to(queue_between(from, core), std::forward<F>(task));
+    }
+
+    std::size_t size() const noexcept { return reactor_count; }
+
+    // index of the reactor running the calling thread, not_a_reactor for any other thread
+    std::size_t this_core() const noexcept { return current_runtime == this ? current_core : not_a_reactor; }
+
+private:
+    queue_type& queue_between(std::size_t from, std::size_t to) noexcept { return *mesh[from * reactor_count + to]; }
+
+    static std::vector<int> affinity_cpus() {
+        std::vector<int> cpus;
+#if defined(__linux__)
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+            }
+        }
+        if (cpus.empty()) {
+            for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) cpus.push_back(int(cpu));
+        }
+#endif
+        return cpus;
+    }
+
+    void pin_to_cpu(std::size_t core) noexcept {
+#if defined(__linux__)
+        if (allowed_cpus.empty()) return;
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(allowed_cpus[(cpu_base + core) % allowed_cpus.size()], &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); // best effort, an unpinned reactor still works
+#else
+        (void)core;
+#endif
+    }
+
+    /*
+    Poll loop:
+        1. sweep every inbound queue (every reactor + the external row), bulk dequeue up to poll_batch tasks and run them
+        2. a sweep that ran nothing counts as idle, after idle_spins of those in a row we start yielding instead of pausing
+        3. once stop() was called, the first fully empty sweep ends the loop
+    */
+    void run_reactor(std::size_t core) {
+        static constexpr std::size_t idle_spins = 1024;
+
+        current_runtime = this;
+        current_core    = core;
+        pin_to_cpu(core);
+
+        task_type batch[poll_batch];
+        std::size_t idle_sweeps = 0;
+
+        for (;;) {
+            const bool still_running = running.load(std::memory_order_acquire);
+
+            std::size_t ran = 0;
+            for (std::size_t from = 0; from <= reactor_count; ++from) {
+                const std::size_t count = queue_between(from, core).try_dequeue_bulk(batch, poll_batch);
+                for (std::size_t i = 0; i < count; ++i) batch[i]();
+                ran += count;
+            }
+
+            if (ran > 0) {
+                idle_sweeps = 0;
+                continue;
+            }
+            if (!still_running) break;
+
+            if (++idle_sweeps < idle_spins) cpu_relax();
+            else std::this_thread::yield();
+        }
+
+        current_runtime = nullptr;
+        current_core    = not_a_reactor;
+    }
+
+    static inline thread_local const reactor_runtime* current_runtime = nullptr;
+    static inline thread_local std::size_t            current_core    = not_a_reactor;
+
+    std::size_t      reactor_count;
+    std::size_t      cpu_base;
+    std::vector<int> allowed_cpus;
+
+    std::vector<std::unique_ptr<queue_type>> mesh;
+    std::vector<std::thread>                 threads;
+    std::atomic<bool>                        running{false};
+    bool                                     started = false; // driving thread only, start()/stop()
+};
+
+};
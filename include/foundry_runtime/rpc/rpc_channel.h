@@ -0,0 +1,278 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#if defined(__linux__)
+    #include <ctime>
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/trace/trace_hooks.h>
+
+namespace foundry_runtime {
+
+/*
+Wait Modes:
+    - poll: waiters spin (cpu_relax, then yield), the submit/respond path never checks for sleepers, no fence, no syscall
+    - futex: waiters spin for a while, then sleep on a futex word inside the channel, the other side pays one fenced
+      load per submitted/responded batch and a FUTEX_WAKE only when someone is actually asleep
+      (off linux futex falls back to polling)
+*/
+enum class rpc_wait { poll, futex };
+
+/*
+Doorbell:
+    - one per direction, same Dekker handshake as spsc_eventfd_channel but the sleep is a futex on `sequence`
+        1. waiter: reads sequence, sets sleeping, fences, rechecks its ring, only then futex waits on the sequence it read
+        2. ringer: after publishing, fences and checks sleeping, if set bumps sequence and wakes
+    - either the waiter's recheck sees the new entry, or the ringer sees sleeping, and a bump that lands between the read
+      and the futex wait makes the wait return straight away
+    - plain uint32 atomics, lock free and address free, so the futex works across processes when the channel is in shm
+*/
+struct alignas(cacheline_size) rpc_doorbell {
+    std::atomic<std::uint32_t> sequence{0}; // written by the ringer
+    std::atomic<std::uint32_t> sleeping{0}; // written by the waiter, only around a sleep
+};
+
+/*
+RPC Channel (io_uring style):
+    - a submission ring (client -> server) and a completion ring (server -> client), each a plain spsc_queue
+    - every submission carries a correlation token from the client, the server copies it into the completion, so the
+      server can complete out of order and the client can keep many calls in flight
+    - submit/respond come in bulk forms, one index release (and one doorbell check) per batch instead of per call
+    - everything lives inline in this object (no pointers, no heap), so it can be placed in shared memory with create_at()
+      and opened in the other process with attach(), the futex waits then drop FUTEX_PRIVATE_FLAG
+
+    client thread: try_submit(), try_submit_bulk(), try_complete(), poll_completions(), wait_completions(), call()
+    server thread: poll_requests(), wait_requests(), try_respond(), try_respond_bulk()
+*/
+template <class Request, class Response, std::size_t capacity = 256, rpc_wait wait_mode = rpc_wait::futex>
+class rpc_channel {
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the futex words must be plain lock free atomics...");
+
+    static constexpr std::size_t stage_batch = 32;
+
+public:
+    struct submission {
+        std::uint64_t token;
+        Request       request;
+    };
+
+    struct completion {
+        std::uint64_t token;
+        Response      response;
+    };
+
+    using submission_queue = spsc_queue<submission, capacity, true, false>;
+    using completion_queue = spsc_queue<completion, capacity, true, false>;
+
+    explicit rpc_channel(bool process_shared = false) : shared(process_shared) {}
+
+    rpc_channel(const rpc_channel&)            = delete;
+    rpc_channel& operator=(const rpc_channel&) = delete;
+
+    // shared memory: construct in place (one process), attach from the other, memory must be cacheline aligned
+    static rpc_channel* create_at(void* memory) { return ::new (memory) rpc_channel(true); }
+    static rpc_channel* attach(void* memory) noexcept { return std::launder(static_cast<rpc_channel*>(memory)); }
+
+    // client side, token is set to the call's correlation token on success
+    bool try_submit(const Request& request, std::uint64_t& token) {
+        const submission entry{client.next_token, request};
+        if (!submissions.try_enqueue(entry)) return false;
+
+        token = client.next_token++;
+        ring(to_server);
+        return true;
+    }
+
+    // client side, submits as many as fit, tokens[i] is filled for each one submitted
+    std::size_t try_submit_bulk(const Request* requests, std::size_t count, std::uint64_t* tokens) {
+        submission staged[stage_batch];
+        std::size_t submitted = 0;
+
+        while (submitted < count) {
+            const std::size_t chunk = count - submitted < stage_batch ? count - submitted : stage_batch;
+            for (std::size_t i = 0; i < chunk; ++i) staged[i] = submission{client.next_token + i, requests[submitted + i]};
+
+            const std::size_t enqueued = submissions.try_enqueue_bulk(staged, chunk);
+            for (std::size_t i = 0; i < enqueued; ++i) tokens[submitted + i] = client.next_token + i;
+            client.next_token += enqueued;
+            submitted         += enqueued;
+
+            if (enqueued < chunk) break;
+        }
+
+        if (submitted) ring(to_server);
+        return submitted;
+    }
+
+    // client side
+    bool try_complete(completion& out) { return completions.try_dequeue(out); }
+    std::size_t poll_completions(completion* out, std::size_t max_count) { return completions.try_dequeue_bulk(out, max_count); }
+
+    // client side, blocks until at least one completion (or the timeout), returns how many were taken
+    std::size_t wait_completions(completion* out, std::size_t max_count, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        return wait_and_take(completions, to_client, out, max_count, timeout);
+    }
+
+    /*
+    Synchronous call:
+        - only for a client with nothing else in flight, false on timeout
+        - a call that timed out still gets its completion later, tokens only grow, so anything older than this call's
+          token is such a late completion and is dropped while we keep waiting (otherwise it would be taken as the next
+          call's answer and every call after it would be off by one)
+        - a completion newer than our token can't come from call() alone, that is the "something else in flight" misuse
+    */
+    bool call(const Request& request, Response& response, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        const auto deadline = timeout == std::chrono::nanoseconds::max()
+            ? std::chrono::steady_clock::time_point::max()
+            : std::chrono::steady_clock::now() + timeout;
+
+        std::uint64_t token;
+        while (!try_submit(request, token)) cpu_relax();
+
+        completion done;
+        for (;;) {
+            const auto remaining = deadline == std::chrono::steady_clock::time_point::max()
+                ? std::chrono::nanoseconds::max()
+                : std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining <= std::chrono::nanoseconds::zero() || wait_completions(&done, 1, remaining) == 0) return false;
+
+            if (done.token < token) continue; // late answer to a call that already timed out
+            if (done.token != token) return false;
+
+            response = done.response;
+            return true;
+        }
+    }
+
+    // server side
+    std::size_t poll_requests(submission* out, std::size_t max_count) { return submissions.try_dequeue_bulk(out, max_count); }
+
+    std::size_t wait_requests(submission* out, std::size_t max_count, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        return wait_and_take(submissions, to_server, out, max_count, timeout);
+    }
+
+    bool try_respond(std::uint64_t token, const Response& response) {
+        if (!completions.try_enqueue(completion{token, response})) return false;
+        ring(to_client);
+        return true;
+    }
+
+    std::size_t try_respond_bulk(const completion* done, std::size_t count) {
+        const std::size_t enqueued = completions.try_enqueue_bulk(done, count);
+        if (enqueued) ring(to_client);
+        return enqueued;
+    }
+
+    // futex wakes actually issued, per direction (any thread)
+    std::uint32_t server_wakeups() const noexcept { return to_server.sequence.load(std::memory_order_relaxed); }
+    std::uint32_t client_wakeups() const noexcept { return to_client.sequence.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::uint32_t yield_rounds = 64;
+
+    // spinning only helps when the other side is running on another hardware thread at the same time
+    static std::uint32_t spin_rounds() noexcept {
+        static const std::uint32_t rounds = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+        return rounds;
+    }
+
+    void ring(rpc_doorbell& doorbell) {
+        if constexpr (wait_mode == rpc_wait::futex) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (doorbell.sleeping.load(std::memory_order_relaxed) == 0) return;
+
+            doorbell.sequence.fetch_add(1, std::memory_order_release);
+            futex(doorbell.sequence, FutexOp::Wake, 0, nullptr);
+            FOUNDRY_TRACE_RUNTIME("rpc.wake", 0, &doorbell);
+        } else {
+            (void)doorbell;
+        }
+    }
+
+    template <class Queue, class Entry>
+    std::size_t wait_and_take(Queue& queue, rpc_doorbell& doorbell, Entry* out, std::size_t max_count, std::chrono::nanoseconds timeout) {
+        const auto deadline = timeout == std::chrono::nanoseconds::max()
+            ? std::chrono::steady_clock::time_point::max()
+            : std::chrono::steady_clock::now() + timeout;
+
+        const std::uint32_t spins = spin_rounds();
+        for (std::uint32_t round = 0;; ++round) {
+            if (const std::size_t taken = queue.try_dequeue_bulk(out, max_count)) return taken;
+
+            if (round < spins) {
+                cpu_relax();
+                continue;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) return 0;
+
+            if (wait_mode == rpc_wait::poll || round < spins + yield_rounds) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // futex sleep, see rpc_doorbell for why this can't miss a wakeup
+            const std::uint32_t seen = doorbell.sequence.load(std::memory_order_acquire);
+            doorbell.sleeping.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (queue.empty()) {
+                const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+                FOUNDRY_TRACE_RUNTIME("rpc.sleep", 0, &doorbell);
+                futex(doorbell.sequence, FutexOp::Wait, seen, deadline == std::chrono::steady_clock::time_point::max() ? nullptr : &remaining);
+            }
+            doorbell.sleeping.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    enum class FutexOp { Wait, Wake };
+
+    void futex(std::atomic<std::uint32_t>& word, FutexOp op, std::uint32_t expected, const std::chrono::nanoseconds* timeout) const noexcept {
+#if defined(__linux__)
+        const int private_flag = shared ? 0 : FUTEX_PRIVATE_FLAG;
+        if (op == FutexOp::Wake) {
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE | private_flag, 1, nullptr, nullptr, 0);
+            return;
+        }
+
+        timespec relative{};
+        if (timeout) {
+            relative.tv_sec  = time_t(timeout->count() / 1'000'000'000);
+            relative.tv_nsec = long(timeout->count() % 1'000'000'000);
+        }
+        // EAGAIN (sequence already moved), EINTR and ETIMEDOUT all just send us back round the loop
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT | private_flag, expected, timeout ? &relative : nullptr, nullptr, 0);
+#else
+        (void)word; (void)expected; (void)timeout;
+        if (op == FutexOp::Wait) std::this_thread::yield();
+#endif
+    }
+
+    struct alignas(cacheline_size) ClientSide {
+        std::uint64_t next_token = 1;
+    };
+
+    bool shared;
+
+    ClientSide   client{};
+    rpc_doorbell to_server{};
+    rpc_doorbell to_client{};
+
+    submission_queue submissions;
+    completion_queue completions;
+};
+
+};
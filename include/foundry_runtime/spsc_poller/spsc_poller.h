@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+SPSC Poller:
+    - one consumer fed by num_queues spsc queues, each with its own producer
+    - instead of round robin try_dequeue over every queue (a miss on each idle queue's write index), producers ring a doorbell
+        - a readiness bitmap, one bit per queue, 64 queues per word and every word on its own cacheline
+        - a producer sets its bit after an enqueue if it isn't set already, so only the first enqueue after the consumer took the bit pays the RMW
+    - the consumer takes a whole word at a time (one exchange), walks the set bits with ctz and only visits queues that have data
+    - each visit drains at most weight(queue) elements, a queue that used its whole weight is carried over to the next poll
+      in a consumer private mask, so a hot queue can't starve the others and the shared word isn't written again for it
+
+Lost wakeup:
+    - the producer does (store write index, load bit), the consumer does (clear bit, load write index), a store buffer race
+    - both sides put a seq_cst fence in between, so at least one of them sees the other: either the bit gets set again or the consumer sees the element
+*/
+template <class QueueType, std::size_t num_queues>
+class spsc_poller {
+    static_assert(num_queues >= 1);
+
+    static constexpr std::size_t bits_per_word = 64;
+    static constexpr std::size_t num_words     = (num_queues + bits_per_word - 1) / bits_per_word;
+
+    struct alignas(cacheline_size) ReadyWord {
+        std::atomic<std::uint64_t> bits{0};
+    };
+
+    using T = typename QueueType::value_type;
+
+public:
+    spsc_poller() {
+        for (auto& queue : queues) queue = std::make_unique<QueueType>();
+        weights.fill(default_weight);
+    }
+
+    spsc_poller(const spsc_poller&)            = delete;
+    spsc_poller& operator=(const spsc_poller&) = delete;
+
+    ~spsc_poller() = default;
+
+    static constexpr std::size_t default_weight = 16;
+
+    // producer side, called by queue_index's producer only
+    bool try_enqueue(std::size_t queue_index, const T& in_data) {
+        if (!queues[queue_index]->try_enqueue(in_data)) return false;
+        ring(queue_index);
+        return true;
+    }
+
+    // for producers that enqueue straight into queue(i) (e.g. in bulk), ring once afterwards
+    void ring(std::size_t queue_index) noexcept {
+        std::atomic<std::uint64_t>& word = ready[queue_index / bits_per_word].bits;
+        const std::uint64_t mask = std::uint64_t{1} << (queue_index % bits_per_word);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!(word.load(std::memory_order_relaxed) & mask)) word.fetch_or(mask, std::memory_order_release);
+    }
+
+    QueueType& queue(std::size_t queue_index) noexcept { return *queues[queue_index]; }
+
+    // consumer side, how many elements one visit may drain from this queue
+    void set_weight(std::size_t queue_index, std::size_t weight) noexcept { weights[queue_index] = weight ? weight : 1; }
+
+    /*
+    poll:
+        1. for every word (starting one further each poll so low indices don't always go first), take the shared bits and merge in our carried ones
+        2. visit each set bit lowest first, drain up to its weight, handing each element to handler(queue_index, element)
+        3. a queue that filled its whole weight probably has more, so its bit is carried to the next poll privately
+    */
+    template <class Handler>
+    std::size_t poll(Handler&& handler) {
+        std::size_t handled = 0;
+        T element;
+
+        for (std::size_t n = 0; n < num_words; ++n) {
+            const std::size_t w = (start_word + n) % num_words;
+
+            std::uint64_t bits = carried[w];
+            if (ready[w].bits.load(std::memory_order_relaxed)) {
+                bits |= ready[w].bits.exchange(0, std::memory_order_acq_rel);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+            carried[w] = 0;
+
+            while (bits) {
+                const std::size_t bit         = std::size_t(__builtin_ctzll(bits));
+                const std::size_t queue_index = w * bits_per_word + bit;
+                bits &= bits - 1;
+
+                std::size_t drained = 0;
+                while (drained < weights[queue_index] && queues[queue_index]->try_dequeue(element)) {
+                    handler(queue_index, element);
+                    drained++;
+                }
+
+                if (drained == weights[queue_index]) carried[w] |= std::uint64_t{1} << bit;
+                handled += drained;
+            }
+        }
+
+        start_word = (start_word + 1) % num_words;
+        return handled;
+    }
+
+private:
+    std::array<ReadyWord, num_words> ready{};
+
+    // consumer private, kept off the ready lines
+    alignas(cacheline_size) std::array<std::uint64_t, num_words> carried{};
+    std::array<std::size_t, num_queues> weights{};
+    std::size_t start_word = 0;
+
+    std::array<std::unique_ptr<QueueType>, num_queues> queues;
+};
+
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/spsc_queue/spsc_stats.h>
+
+namespace foundry_runtime {
+
+/*
+B-Queue style queue:
+    - slots carry their own full flag like spsc_ff_queue, the consumer clears them strictly in order
+    - so if slot (write + n - 1) is free, every slot from write up to it is free as well
+    - the producer probes one slot a batch ahead and then writes the whole batch without touching anything the consumer writes
+    - when the consumer lags just behind on another core, each spsc_queue refresh of read_next only frees a slot or two,
+      so it can end up refreshing on nearly every enqueue, here it is one probe per batch
+
+Backtracking:
+    1. probe at the current batch size, halve it until a free slot is found or we run out (queue full)
+    2. a first-try hit doubles the batch size (up to max_batch), so a fast consumer gets long batches
+    3. a backtracked hit drops the batch size to what actually fit, so a near-full ring doesn't pay for doomed big probes
+*/
+template <class T, std::size_t capacity, std::size_t max_batch = capacity / 4, class stats_policy = spsc_no_stats>
+class spsc_bqueue {
+    static_assert(capacity >= 2);
+    static_assert(std::is_trivially_copyable_v<T>, "Trivially Copyable T NOT Provided...");
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be power of two...");
+    static_assert(max_batch >= 1 && max_batch <= capacity / 2, "batch must leave the consumer room...");
+
+    static constexpr std::size_t capacity_mask = capacity - 1;
+
+    struct Slot {
+        std::atomic<bool> full{false};
+        T data;
+    };
+
+    // batch state is producer private, it lives on the producer's line with its index and counters
+    struct alignas(cacheline_size) ProducerSide {
+        std::size_t write_next = 0;
+        std::size_t batch_head = 0;
+        std::size_t batch_size = max_batch;
+        [[no_unique_address]] typename stats_policy::producer_counters stats{};
+    };
+
+    struct alignas(cacheline_size) ConsumerSide {
+        std::size_t read_next = 0;
+        [[no_unique_address]] typename stats_policy::consumer_counters stats{};
+    };
+
+public:
+    spsc_bqueue()                              = default;
+    spsc_bqueue(const spsc_bqueue&)            = delete;
+    spsc_bqueue& operator=(const spsc_bqueue&) = delete;
+
+    ~spsc_bqueue() = default;
+
+    bool try_enqueue(const T& in_data) {
+        if (producer.write_next == producer.batch_head) {
+            producer.stats.on_cache_refresh();
+            if (!probe_batch()) {
+                producer.stats.on_full();
+                return false;
+            }
+        } else {
+            producer.stats.on_cache_hit();
+        }
+
+        Slot& slot = queue[producer.write_next];
+        slot.data = in_data;
+        slot.full.store(true, std::memory_order_release);
+
+        producer.write_next = (producer.write_next + 1) & capacity_mask;
+
+        return true;
+    }
+
+    bool try_dequeue(T& out_data) {
+        Slot& slot = queue[consumer.read_next];
+
+        if (!slot.full.load(std::memory_order_acquire)) {
+            consumer.stats.on_empty();
+            return false;
+        }
+
+        out_data = slot.data;
+        slot.full.store(false, std::memory_order_release);
+
+        consumer.read_next = (consumer.read_next + 1) & capacity_mask;
+
+        consumer.stats.on_dequeue();
+
+        return true;
+    }
+
+    // probes are reported as producer cache refreshes, writes inside a batch as cache hits (no high water, the producer never sees the read index)
+    spsc_stats_snapshot stats() const noexcept {
+        spsc_stats_snapshot snapshot;
+        producer.stats.snapshot_into(snapshot);
+        consumer.stats.snapshot_into(snapshot);
+        return snapshot;
+    }
+
+private:
+    bool probe_batch() noexcept {
+        const std::size_t write = producer.write_next;
+
+        for (std::size_t size = producer.batch_size; size >= 1; size >>= 1) {
+            // acquire pairs with the consumer's release of that slot, and it cleared every slot before it first
+            if (!queue[(write + size - 1) & capacity_mask].full.load(std::memory_order_acquire)) {
+                producer.batch_head = (write + size) & capacity_mask;
+                producer.batch_size = size == producer.batch_size ? grow(size) : size;
+                return true;
+            }
+        }
+
+        producer.batch_size = 1;
+        return false;
+    }
+
+    static constexpr std::size_t grow(std::size_t size) noexcept { return size * 2 > max_batch ? max_batch : size * 2; }
+
+    ProducerSide producer{};
+    ConsumerSide consumer{};
+
+    alignas(cacheline_size) Slot queue[capacity];
+};
+
+};
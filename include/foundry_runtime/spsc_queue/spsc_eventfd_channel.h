@@ -0,0 +1,124 @@
+#pragma once
+
+#if !defined(__linux__)
+    #error "spsc_eventfd_channel needs eventfd (linux only)"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/trace/trace_hooks.h>
+
+namespace foundry_runtime {
+
+/*
+eventfd Channel:
+    - wraps an spsc queue for consumers that sleep in epoll (sockets, timers...) instead of spinning on try_dequeue
+    - the consumer puts fd() in its epoll set, the producer only writes the eventfd when the consumer said it is going to sleep
+    - so a busy consumer never costs the producer a syscall, but every enqueue still pays one seq_cst fence (mfence or a
+      locked op on x86, tens of cycles) plus a load of the parked flag, the fence is what makes the handshake below safe
+        - try_enqueue_bulk() pays that fence once per batch, use it when the producer has several messages at hand
+
+Parking protocol:
+    1. consumer: prepare_park() sets parked, fences, then rechecks the queue
+        a. not empty => parked is cleared again and it returns false, go drain instead of sleeping
+        b. still empty => returns true, safe to epoll_wait
+    2. producer: after every enqueue (or bulk enqueue) it fences and checks parked, the one that exchanges it back to false
+       writes the eventfd
+    3. consumer: on waking call on_readable() when epoll reported fd(), or cancel_park() when something else woke it
+
+    the two fences make it a Dekker handshake, either the consumer's recheck sees the element or the producer sees parked
+*/
+template <class QueueType>
+class spsc_eventfd_channel {
+    using T = typename QueueType::value_type;
+
+    struct alignas(cacheline_size) ConsumerSide {
+        std::atomic<bool> parked{false}; // only written when parking/unparking, so the producer's load is a shared line hit while busy
+    };
+
+    struct alignas(cacheline_size) ProducerSide {
+        std::atomic<std::uint64_t> wakeups{0};
+    };
+
+public:
+    spsc_eventfd_channel() : event_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (event_fd < 0) throw std::system_error(errno, std::generic_category(), "spsc_eventfd_channel: eventfd");
+    }
+
+    spsc_eventfd_channel(const spsc_eventfd_channel&)            = delete;
+    spsc_eventfd_channel& operator=(const spsc_eventfd_channel&) = delete;
+
+    ~spsc_eventfd_channel() { ::close(event_fd); }
+
+    // producer side
+    bool try_enqueue(const T& in_data) {
+        if (!queue.try_enqueue(in_data)) return false;
+        wake_if_parked();
+        return true;
+    }
+
+    // producer side, one index release and one fence for the whole batch, returns how many went in
+    std::size_t try_enqueue_bulk(const T* in_data, std::size_t count) {
+        const std::size_t enqueued = queue.try_enqueue_bulk(in_data, count);
+        if (enqueued) wake_if_parked();
+        return enqueued;
+    }
+
+    // consumer side
+    bool try_dequeue(T& out_data) { return queue.try_dequeue(out_data); }
+
+    int fd() const noexcept { return event_fd; }
+
+    bool prepare_park() {
+        consumer.parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!queue.empty()) {
+            consumer.parked.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        FOUNDRY_TRACE_RUNTIME("eventfd.park", 0, this);
+        return true;
+    }
+
+    void on_readable() noexcept {
+        std::uint64_t count;
+        [[maybe_unused]] const ssize_t bytes = ::read(event_fd, &count, sizeof(count)); // EAGAIN just means someone else already reset it
+        consumer.parked.store(false, std::memory_order_relaxed);
+        FOUNDRY_TRACE_RUNTIME("eventfd.woken", 0, this);
+    }
+
+    void cancel_park() noexcept { consumer.parked.store(false, std::memory_order_relaxed); }
+
+    // how many times the producer had to write the eventfd (readable from any thread)
+    std::uint64_t wakeups() const noexcept { return producer.wakeups.load(std::memory_order_relaxed); }
+
+    QueueType& underlying_queue() noexcept { return queue; }
+
+private:
+    void wake_if_parked() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer.parked.load(std::memory_order_relaxed) && consumer.parked.exchange(false, std::memory_order_acq_rel)) {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const ssize_t written = ::write(event_fd, &one, sizeof(one)); // only fails if the counter would overflow, it is still readable then
+            producer.wakeups.store(producer.wakeups.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            FOUNDRY_TRACE_RUNTIME("eventfd.wake", 0, this);
+        }
+    }
+
+    int event_fd;
+
+    ProducerSide producer{};
+    ConsumerSide consumer{};
+
+    QueueType queue;
+};
+
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+FastForward style queue:
+    - every slot carries its own full flag, so the only shared state is the slots themselves
+    - the producer checks the flag of the slot it wants to write, the consumer checks the flag of the slot it wants to read
+    - neither side ever reads the other's index, so there are no index lines to bounce (unlike spsc_queue's cache refresh)
+    - slots are padded to a power of two size so a slot never straddles two cachelines, each op touches exactly one line
+    - at low occupancy both sides are on the same slot line anyway, which is the one line the data has to cross regardless
+*/
+template <class T, std::size_t capacity>
+class spsc_ff_queue {
+    static_assert(capacity >= 2);
+    static_assert(std::is_trivially_copyable_v<T>, "Trivially Copyable T NOT Provided...");
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be power of two...");
+
+    static constexpr std::size_t capacity_mask = capacity - 1;
+
+    static constexpr std::size_t next_power_of_two(std::size_t n) noexcept {
+        std::size_t power = 1;
+        while (power < n) power <<= 1;
+        return power;
+    }
+
+    struct UnalignedSlot {
+        std::atomic<bool> full{false};
+        T data;
+    };
+
+    struct alignas(next_power_of_two(sizeof(UnalignedSlot))) Slot : UnalignedSlot {};
+
+    static_assert(sizeof(Slot) % cacheline_size == 0 || cacheline_size % sizeof(Slot) == 0, "slot must tile cachelines...");
+
+    struct alignas(cacheline_size) PaddedIndex {
+        std::size_t loc = 0; // private to one side, padded so it doesn't land next to the other side's index or the slots
+    };
+
+public:
+    spsc_ff_queue()                                = default;
+    spsc_ff_queue(const spsc_ff_queue&)            = delete;
+    spsc_ff_queue& operator=(const spsc_ff_queue&) = delete;
+
+    ~spsc_ff_queue() = default;
+
+    bool try_enqueue(const T& in_data) {
+        Slot& slot = queue[write_next.loc];
+
+        // the consumer clears the flag only after it copied the data out, so acquire here keeps our write after its read
+        if (slot.full.load(std::memory_order_acquire)) return false;
+
+        slot.data = in_data;
+        slot.full.store(true, std::memory_order_release);
+
+        write_next.loc = (write_next.loc + 1) & capacity_mask;
+
+        return true;
+    }
+
+    bool try_dequeue(T& out_data) {
+        Slot& slot = queue[read_next.loc];
+
+        if (!slot.full.load(std::memory_order_acquire)) return false;
+
+        out_data = slot.data;
+        slot.full.store(false, std::memory_order_release);
+
+        read_next.loc = (read_next.loc + 1) & capacity_mask;
+
+        return true;
+    }
+
+private:
+    PaddedIndex write_next{};
+    PaddedIndex read_next{};
+
+    alignas(cacheline_size) Slot queue[capacity];
+};
+
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+Micro Queue:
+    - meant for the tiny (2-8 slot) control/handoff rings where spsc_queue's padding costs more than the data
+    - indices are 16 bit (32 bit for big capacities) and free running, so all capacity slots are usable (no sacrificed slot)
+    - indices and slots are packed together, so the whole queue is ceil((2 * sizeof(index) + sizeof(T) * capacity) / cacheline_size) lines
+    - the tradeoff is that producer and consumer deliberately share those lines, the win is L1/L2 footprint when there are hundreds of these
+*/
+template <class T, std::size_t capacity>
+class alignas(cacheline_size) spsc_micro_queue {
+    static_assert(capacity >= 2);
+    static_assert(std::is_trivially_copyable_v<T>, "Trivially Copyable T NOT Provided...");
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be power of two...");
+    static_assert(capacity <= (std::size_t{1} << 31), "capacity must fit a 32 bit free running index...");
+
+    using IndexType = std::conditional_t<(capacity <= (std::size_t{1} << 15)), std::uint16_t, std::uint32_t>;
+
+    static_assert(std::atomic<IndexType>::is_always_lock_free);
+
+    static constexpr IndexType capacity_mask = IndexType(capacity - 1);
+
+public:
+    spsc_micro_queue()                                   = default;
+    spsc_micro_queue(const spsc_micro_queue&)            = delete;
+    spsc_micro_queue& operator=(const spsc_micro_queue&) = delete;
+
+    ~spsc_micro_queue() = default;
+
+    bool try_enqueue(const T& in_data) {
+        const IndexType current_write_loc = write_next.load(std::memory_order_relaxed);
+
+        // both indices live on the same line, so there is nothing to gain from caching the read index
+        if (IndexType(current_write_loc - read_next.load(std::memory_order_acquire)) == capacity) return false;
+
+        queue[current_write_loc & capacity_mask] = in_data;
+        write_next.store(IndexType(current_write_loc + 1), std::memory_order_release);
+
+        return true;
+    }
+
+    bool try_dequeue(T& out_data) {
+        const IndexType current_read_loc = read_next.load(std::memory_order_relaxed);
+
+        if (current_read_loc == write_next.load(std::memory_order_acquire)) return false;
+
+        out_data = queue[current_read_loc & capacity_mask];
+        read_next.store(IndexType(current_read_loc + 1), std::memory_order_release);
+
+        return true;
+    }
+
+    static constexpr std::size_t cachelines_used() noexcept { return sizeof(spsc_micro_queue) / cacheline_size; }
+
+private:
+    std::atomic<IndexType> write_next{0};
+    std::atomic<IndexType> read_next{0};
+
+    T queue[capacity];
+};
+
+};
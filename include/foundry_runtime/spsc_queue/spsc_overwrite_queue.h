@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+Overwrite Queue:
+    - for telemetry/debug feeds where losing the oldest entries beats backpressure on the hot path
+    - the producer never waits and never fails, once the ring is full it just overwrites the oldest slot
+    - every slot carries a seqlock style sequence derived from the free running position written into it
+        - 2 * (position + 1) once the write is done, one less than that while it is in flight
+    - the consumer knows which position it wants, so the slot's sequence tells it everything
+        1. sequence below what it expects => not written yet (empty)
+        2. sequence equal => copy, then recheck the sequence to catch a producer that lapped us mid copy
+        3. sequence above => we were lapped, jump to the oldest entry still in the ring and count what we skipped
+*/
+template <class T, std::size_t capacity>
+class spsc_overwrite_queue {
+    static_assert(capacity >= 2);
+    static_assert(std::is_trivially_copyable_v<T>, "Trivially Copyable T NOT Provided...");
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be power of two...");
+
+    static constexpr std::size_t capacity_mask = capacity - 1;
+
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        T data;
+    };
+
+    // write_next is only read by the consumer when it has been lapped, read_next and lost are consumer private
+    struct alignas(cacheline_size) ProducerSide {
+        std::atomic<std::uint64_t> write_next{0};
+    };
+
+    struct alignas(cacheline_size) ConsumerSide {
+        std::uint64_t read_next = 0;
+        std::uint64_t lost      = 0;
+    };
+
+public:
+    spsc_overwrite_queue()                                       = default;
+    spsc_overwrite_queue(const spsc_overwrite_queue&)            = delete;
+    spsc_overwrite_queue& operator=(const spsc_overwrite_queue&) = delete;
+
+    ~spsc_overwrite_queue() = default;
+
+    void enqueue(const T& in_data) noexcept {
+        const std::uint64_t position = producer.write_next.load(std::memory_order_relaxed);
+        Slot& slot = queue[position & capacity_mask];
+
+        slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&slot.data, &in_data, sizeof(T));
+
+        slot.sequence.store(2 * position + 2, std::memory_order_release);
+        producer.write_next.store(position + 1, std::memory_order_release);
+    }
+
+    bool try_dequeue(T& out_data) noexcept {
+        for (;;) {
+            const std::uint64_t position = consumer.read_next;
+            const std::uint64_t expected = 2 * position + 2;
+            const Slot& slot = queue[position & capacity_mask];
+
+            const std::uint64_t sequence_before = slot.sequence.load(std::memory_order_acquire);
+            if (sequence_before < expected) return false;
+
+            if (sequence_before == expected) {
+                // racy copy by design, the recheck throws it away if the producer came back around to this slot
+                std::memcpy(&out_data, &slot.data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (slot.sequence.load(std::memory_order_relaxed) == sequence_before) {
+                    consumer.read_next = position + 1;
+                    return true;
+                }
+            }
+
+            resync();
+        }
+    }
+
+    // total entries the consumer skipped because the producer overwrote them first (consumer thread only)
+    std::uint64_t lost() const noexcept { return consumer.lost; }
+
+private:
+    void resync() noexcept {
+        // the slot at write - capacity is the one the producer is about to (or already started to) overwrite, so skip it as well
+        const std::uint64_t write  = producer.write_next.load(std::memory_order_acquire);
+        const std::uint64_t oldest = write - capacity + 1;
+
+        // the lapping sequence can become visible before the matching write_next does, just look again
+        if (write < capacity || oldest <= consumer.read_next) {
+            cpu_relax();
+            return;
+        }
+
+        consumer.lost     += oldest - consumer.read_next;
+        consumer.read_next = oldest;
+    }
+
+    ProducerSide producer{};
+    ConsumerSide consumer{};
+
+    alignas(cacheline_size) Slot queue[capacity];
+};
+
+};
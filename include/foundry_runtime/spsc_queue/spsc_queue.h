@@ -6,26 +6,12 @@
 #include <utility>
 #include <new>
 
-#if defined(__cpp_lib_hardware_interference_size)
-    static constexpr std::size_t cacheline_size = std::hardware_destructive_interference_size;
-#elif defined(__APPLE__) && defined(__aarch64__)
-    static constexpr std::size_t cacheline_size = 128;
-#else   
-    static constexpr std::size_t cacheline_size = 64;
-#endif
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/spsc_queue/spsc_stats.h>
 
 namespace foundry_runtime {
 
-static inline void sw_prefetch_read(const void* p) noexcept {
-    __builtin_prefetch(p, 0, 3);
-}
-
-static inline void sw_prefetch_write(const void* p) noexcept {
-    __builtin_prefetch(p, 1, 3);
-}
-
-
-template <class T, size_t capacity, bool enable_cacheline_padding, bool enable_prefetch>
+template <class T, size_t capacity, bool enable_cacheline_padding, bool enable_prefetch, class stats_policy = spsc_no_stats>
 class spsc_queue {
     static_assert(capacity >= 2);
     static_assert(std::is_trivially_copyable_v<T>, "Trivially Copyable T NOT Provided...");    
@@ -33,24 +19,46 @@ class spsc_queue {
 
     static constexpr std::size_t capacity_mask = capacity - 1;
 
-    struct alignas(cacheline_size) PaddedLine {
-        std::atomic<std::size_t> r_w_index{0};
-        char pad[cacheline_size - sizeof(std::atomic<std::size_t>)]{}; // basically hogs the rest of the cacheline so that read and write indeces never share the same line
+    /*
+    Layout:
+        - the producer owns one line: the shared write index, its private cached read index and its counters
+        - the consumer owns the other: the shared read index, its private cached write index and its counters
+        - an operation that hits its cached index touches exactly one metadata line (its own) plus the slot
+        - the peer only pulls our line over when it refreshes its cache, which it had to do for the index anyway
+    */
+    struct ProducerSide {
+        std::atomic<std::size_t> write_next{0};
+        std::size_t cached_read_loc = 0;
+        [[no_unique_address]] typename stats_policy::producer_counters stats{};
     };
 
-    struct UnpaddedLine {
-        std::atomic<std::size_t> r_w_index{0};
+    struct ConsumerSide {
+        std::atomic<std::size_t> read_next{0};
+        std::size_t cached_write_loc = 0;
+        [[no_unique_address]] typename stats_policy::consumer_counters stats{};
     };
 
-    static_assert(sizeof(PaddedLine) == cacheline_size);
+    template <class Side>
+    struct alignas(cacheline_size) PaddedLine : Side {}; // alignas rounds the size up, so the rest of the line is ours and the two sides never share
 
-    using IndexType = std::conditional_t<
+    template <class Side>
+    struct UnpaddedLine : Side {};
+
+    template <class Side>
+    using LineType = std::conditional_t<
         enable_cacheline_padding,
-        PaddedLine,
-        UnpaddedLine
+        PaddedLine<Side>,
+        UnpaddedLine<Side>
     >;
 
+    using SlotStamps = spsc_slot_stamps<stats_policy, capacity>;
+
+    static_assert(sizeof(PaddedLine<ProducerSide>) == cacheline_size, "producer state spills past one cacheline...");
+    static_assert(sizeof(PaddedLine<ConsumerSide>) == cacheline_size, "consumer state spills past one cacheline...");
+
 public:
+    using value_type = T;
+
     spsc_queue()                             = default;
     spsc_queue(const spsc_queue&)            = delete;
     spsc_queue& operator=(const spsc_queue&) = delete;
@@ -69,48 +77,182 @@ public:
             4. We do a prefetch if it is enabled
             5. We the queue write, increment the atomic write index, and release it
         */
-        auto current_write_loc = write_next.r_w_index.load(std::memory_order_relaxed);
+        auto current_write_loc = producer.write_next.load(std::memory_order_relaxed);
         auto next_loc          = increment(current_write_loc);
 
-        if (next_loc == cached_read_loc) {
-            cached_read_loc = read_next.r_w_index.load(std::memory_order_acquire);
-            if (next_loc == cached_read_loc) return false;
+        if (next_loc == producer.cached_read_loc) {
+            producer.stats.on_cache_refresh();
+            producer.cached_read_loc = consumer.read_next.load(std::memory_order_acquire);
+            if (next_loc == producer.cached_read_loc) {
+                producer.stats.on_full();
+                return false;
+            }
+        } else {
+            producer.stats.on_cache_hit();
         }
 
         if constexpr (enable_prefetch) sw_prefetch_write(&queue[current_write_loc]);
         queue[current_write_loc] = in_data;
+        if constexpr (SlotStamps::enabled) producer.stats.on_slot_written(stamps, current_write_loc);
+
+        producer.write_next.store(next_loc, std::memory_order_release);
 
-        write_next.r_w_index.store(next_loc, std::memory_order_release);
+        producer.stats.on_enqueue((next_loc - producer.cached_read_loc) & capacity_mask);
         
         return true;
     }
 
+    // producer side mirror of try_dequeue_bulk: enqueues as many of count as fit, one release of write_next for all of them
+    std::size_t try_enqueue_bulk(const T* in_data, std::size_t count) {
+        auto current_write_loc = producer.write_next.load(std::memory_order_relaxed);
+        auto free_slots        = (producer.cached_read_loc - current_write_loc - 1) & capacity_mask;
+
+        if (free_slots < count) {
+            producer.stats.on_cache_refresh();
+            producer.cached_read_loc = consumer.read_next.load(std::memory_order_acquire);
+            free_slots = (producer.cached_read_loc - current_write_loc - 1) & capacity_mask;
+            if (free_slots == 0) {
+                producer.stats.on_full();
+                return 0;
+            }
+        } else {
+            producer.stats.on_cache_hit();
+        }
+
+        const std::size_t enqueued   = free_slots < count ? free_slots : count;
+        const std::size_t first_part = enqueued < capacity - current_write_loc ? enqueued : capacity - current_write_loc;
+
+        if constexpr (enable_prefetch) sw_prefetch_write(&queue[current_write_loc]);
+        for (std::size_t i = 0; i < first_part; ++i) queue[current_write_loc + i] = in_data[i];
+        for (std::size_t i = first_part; i < enqueued; ++i) queue[i - first_part] = in_data[i];
+        if constexpr (SlotStamps::enabled) {
+            for (std::size_t i = 0; i < enqueued; ++i) producer.stats.on_slot_written(stamps, (current_write_loc + i) & capacity_mask);
+        }
+
+        const auto next_loc = (current_write_loc + enqueued) & capacity_mask;
+        producer.write_next.store(next_loc, std::memory_order_release);
+
+        producer.stats.on_enqueue((next_loc - producer.cached_read_loc) & capacity_mask);
+
+        return enqueued;
+    }
+
     bool try_dequeue(T& out_data) {
-        auto current_read_loc = read_next.r_w_index.load(std::memory_order_relaxed);
+        auto current_read_loc = consumer.read_next.load(std::memory_order_relaxed);
 
-        if (current_read_loc == cached_write_loc) {
-            cached_write_loc = write_next.r_w_index.load(std::memory_order_acquire);
-            if (current_read_loc == cached_write_loc) return false;
+        if (current_read_loc == consumer.cached_write_loc) {
+            consumer.stats.on_cache_refresh();
+            consumer.cached_write_loc = producer.write_next.load(std::memory_order_acquire);
+            if (current_read_loc == consumer.cached_write_loc) {
+                consumer.stats.on_empty();
+                return false;
+            }
+        } else {
+            consumer.stats.on_cache_hit();
         }
 
         if constexpr (enable_prefetch) sw_prefetch_read(&queue[current_read_loc]);
         out_data = queue[current_read_loc];
+        if constexpr (SlotStamps::enabled) consumer.stats.on_slot_read(stamps, current_read_loc);
+
+        consumer.read_next.store(increment(current_read_loc), std::memory_order_release);
 
-        read_next.r_w_index.store(increment(current_read_loc), std::memory_order_release);
+        consumer.stats.on_dequeue();
         
         return true;
     }
 
+    /*
+    Bulk dequeue:
+        - one acquire of write_next (only if the cached one doesn't already cover max_count) for up to max_count elements
+        - one release of read_next for the whole batch, so the producer sees a single index update instead of max_count
+        - the copy is split in two when the batch wraps past the end of the ring
+    */
+    std::size_t try_dequeue_bulk(T* out_data, std::size_t max_count) {
+        auto current_read_loc = consumer.read_next.load(std::memory_order_relaxed);
+        auto available        = (consumer.cached_write_loc - current_read_loc) & capacity_mask;
+
+        if (available < max_count) {
+            consumer.stats.on_cache_refresh();
+            consumer.cached_write_loc = producer.write_next.load(std::memory_order_acquire);
+            available = (consumer.cached_write_loc - current_read_loc) & capacity_mask;
+            if (available == 0) {
+                consumer.stats.on_empty();
+                return 0;
+            }
+        } else {
+            consumer.stats.on_cache_hit();
+        }
+
+        const std::size_t count      = available < max_count ? available : max_count;
+        const std::size_t first_part = count < capacity - current_read_loc ? count : capacity - current_read_loc;
+
+        if constexpr (enable_prefetch) sw_prefetch_read(&queue[current_read_loc]);
+        for (std::size_t i = 0; i < first_part; ++i) out_data[i] = queue[current_read_loc + i];
+        for (std::size_t i = first_part; i < count; ++i) out_data[i] = queue[i - first_part];
+        if constexpr (SlotStamps::enabled) {
+            for (std::size_t i = 0; i < count; ++i) consumer.stats.on_slot_read(stamps, (current_read_loc + i) & capacity_mask);
+        }
+
+        consumer.read_next.store((current_read_loc + count) & capacity_mask, std::memory_order_release);
+
+        consumer.stats.on_dequeue();
+
+        return count;
+    }
+
+    // any thread, two plain loads of the shared indices (no writes), so it is only a snapshot
+    std::size_t size_approx() const noexcept {
+        const auto read_loc  = consumer.read_next.load(std::memory_order_acquire);
+        const auto write_loc = producer.write_next.load(std::memory_order_acquire);
+        return (write_loc - read_loc) & capacity_mask;
+    }
+
+    /*
+    Producer side occupancy:
+        - write_next - cached_read_loc, both live on the producer's own line, so asking never touches the consumer's line
+        - the cached read index only ever lags, so this is an upper bound: a low answer is exact enough, a high one may be stale
+        - refresh_producer_occupancy() re-reads read_next first (one shared load, still no shared writes)
+    */
+    std::size_t producer_occupancy() const noexcept {
+        return (producer.write_next.load(std::memory_order_relaxed) - producer.cached_read_loc) & capacity_mask;
+    }
+
+    std::size_t refresh_producer_occupancy() noexcept {
+        producer.stats.on_cache_refresh();
+        producer.cached_read_loc = consumer.read_next.load(std::memory_order_acquire);
+        return producer_occupancy();
+    }
+
+    // consumer side, refreshes the cached write index so a false answer is as fresh as try_dequeue's would be
+    bool empty() {
+        const auto current_read_loc = consumer.read_next.load(std::memory_order_relaxed);
+        if (current_read_loc != consumer.cached_write_loc) return false;
+
+        consumer.cached_write_loc = producer.write_next.load(std::memory_order_acquire);
+        return current_read_loc == consumer.cached_write_loc;
+    }
+
+    // safe from any thread, every counter is a relaxed load (all zeros with spsc_no_stats)
+    spsc_stats_snapshot stats() const noexcept {
+        spsc_stats_snapshot snapshot;
+        producer.stats.snapshot_into(snapshot);
+        consumer.stats.snapshot_into(snapshot);
+        return snapshot;
+    }
+
+    // the policy's own state, for policies that keep more than spsc_stats_snapshot can carry (any thread, read only)
+    const typename SlotStamps::type& slot_stamps() const noexcept { return stamps; }
+
 private:
     static constexpr std::size_t increment(std::size_t i) noexcept { return (i + 1) & capacity_mask; }
 
-    IndexType write_next{}; 
-    IndexType read_next{}; 
-
-    alignas(cacheline_size) std::size_t cached_read_loc = 0;
-    alignas(cacheline_size) std::size_t cached_write_loc = 0; 
+    LineType<ProducerSide> producer{};
+    LineType<ConsumerSide> consumer{};
 
     alignas(cacheline_size) T queue[capacity];
+
+    [[no_unique_address]] typename SlotStamps::type stamps{};
 };
 
 };
\ No newline at end of file
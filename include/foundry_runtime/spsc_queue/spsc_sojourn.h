@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <foundry_runtime/hardware/hardware.h>
+#include <foundry_runtime/hdr_histogram/concurrent_hdr_histogram.h>
+#include <foundry_runtime/spsc_queue/spsc_stats.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+namespace foundry_runtime {
+
+/*
+Sojourn sampling policy:
+    - measures how long elements sit in the queue, 1 in sample_every of them, in tsc ticks
+    - the producer stamps read_tsc() into a side array entry for the sampled element's slot, the consumer reads the stamp
+      when it copies that slot out and records now - stamp into a concurrent_hdr_histogram
+    - both sides count elements with a private countdown, and the queue is FIFO, so the consumer knows which elements
+      were sampled without reading the side array for the other sample_every - 1
+    - the side array is ordered by the queue's own index acquire/release (see spsc_slot_stamps), no extra atomics
+    - a monitor thread reads queue.slot_stamps().sojourn_ticks.snapshot() whenever it likes and converts with a
+      tsc_clock, stamps from two cores only compare on an invariant tsc (tsc_is_invariant())
+    - spsc_stats_snapshot stays all zeros, the histogram is the output
+*/
+template <std::uint32_t sample_every = 64, std::size_t sub_bucket_bits = 5>
+struct spsc_sojourn_stats {
+    static_assert(sample_every >= 1);
+
+    template <std::size_t capacity>
+    struct slot_stamps {
+        std::uint64_t enqueue_tsc[capacity]{};
+
+        alignas(cacheline_size) concurrent_hdr_histogram<sub_bucket_bits> sojourn_ticks; // consumer writes, anyone reads
+    };
+
+    struct producer_counters {
+        std::uint32_t countdown = sample_every;
+
+        void on_full()                  noexcept {}
+        void on_cache_hit()             noexcept {}
+        void on_cache_refresh()         noexcept {}
+        void on_enqueue(std::size_t)    noexcept {}
+        void snapshot_into(spsc_stats_snapshot&) const noexcept {}
+
+        template <class Stamps>
+        void on_slot_written(Stamps& stamps, std::size_t slot) noexcept {
+            if (--countdown != 0) return;
+            countdown = sample_every;
+            stamps.enqueue_tsc[slot] = read_tsc();
+        }
+    };
+
+    struct consumer_counters {
+        std::uint32_t countdown = sample_every;
+
+        void on_empty()                 noexcept {}
+        void on_cache_hit()             noexcept {}
+        void on_cache_refresh()         noexcept {}
+        void on_dequeue()               noexcept {}
+        void snapshot_into(spsc_stats_snapshot&) const noexcept {}
+
+        template <class Stamps>
+        void on_slot_read(Stamps& stamps, std::size_t slot) noexcept {
+            if (--countdown != 0) return;
+            countdown = sample_every;
+            const std::uint64_t now = read_tsc();
+            const std::uint64_t enqueued_at = stamps.enqueue_tsc[slot];
+            stamps.sojourn_ticks.record(now > enqueued_at ? now - enqueued_at : 0); // clamp a little cross core skew
+        }
+    };
+};
+
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace foundry_runtime {
+
+struct spsc_stats_snapshot {
+    std::uint64_t failed_enqueues          = 0; // try_enqueue returned false (full)
+    std::uint64_t failed_dequeues          = 0; // try_dequeue returned false (empty)
+    std::uint64_t producer_cache_hits      = 0; // cached_read_loc was enough, read index never touched
+    std::uint64_t producer_cache_refreshes = 0; // had to acquire the consumer's read index
+    std::uint64_t consumer_cache_hits      = 0; // cached_write_loc was enough, write index never touched
+    std::uint64_t consumer_cache_refreshes = 0; // had to acquire the producer's write index
+    std::uint64_t high_water_occupancy     = 0; // producer's view, so an upper bound between refreshes
+};
+
+/*
+Stats policies:
+    - every hook is called from exactly one side, so each side's counters only have a single writer
+    - the counting policy bumps with a relaxed load + store instead of a locked RMW, the monitor thread just loads
+    - the no stats policy is all empty inline functions and an empty struct, so it compiles to nothing
+*/
+struct spsc_no_stats {
+    struct producer_counters {
+        void on_full()                  noexcept {}
+        void on_cache_hit()             noexcept {}
+        void on_cache_refresh()         noexcept {}
+        void on_enqueue(std::size_t)    noexcept {}
+        void snapshot_into(spsc_stats_snapshot&) const noexcept {}
+    };
+
+    struct consumer_counters {
+        void on_empty()                 noexcept {}
+        void on_cache_hit()             noexcept {}
+        void on_cache_refresh()         noexcept {}
+        void on_dequeue()               noexcept {}
+        void snapshot_into(spsc_stats_snapshot&) const noexcept {}
+    };
+};
+
+struct spsc_counting_stats {
+    static void bump(std::atomic<std::uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    struct producer_counters {
+        std::atomic<std::uint64_t> full{0};
+        std::atomic<std::uint64_t> cache_hits{0};
+        std::atomic<std::uint64_t> cache_refreshes{0};
+        std::atomic<std::uint64_t> high_water{0};
+
+        void on_full()          noexcept { bump(full); }
+        void on_cache_hit()     noexcept { bump(cache_hits); }
+        void on_cache_refresh() noexcept { bump(cache_refreshes); }
+
+        void on_enqueue(std::size_t occupancy) noexcept {
+            if (occupancy > high_water.load(std::memory_order_relaxed)) high_water.store(occupancy, std::memory_order_relaxed);
+        }
+
+        void snapshot_into(spsc_stats_snapshot& out) const noexcept {
+            out.failed_enqueues          = full.load(std::memory_order_relaxed);
+            out.producer_cache_hits      = cache_hits.load(std::memory_order_relaxed);
+            out.producer_cache_refreshes = cache_refreshes.load(std::memory_order_relaxed);
+            out.high_water_occupancy     = high_water.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct consumer_counters {
+        std::atomic<std::uint64_t> empty{0};
+        std::atomic<std::uint64_t> cache_hits{0};
+        std::atomic<std::uint64_t> cache_refreshes{0};
+
+        void on_empty()         noexcept { bump(empty); }
+        void on_cache_hit()     noexcept { bump(cache_hits); }
+        void on_cache_refresh() noexcept { bump(cache_refreshes); }
+        void on_dequeue()       noexcept {}
+
+        void snapshot_into(spsc_stats_snapshot& out) const noexcept {
+            out.failed_dequeues          = empty.load(std::memory_order_relaxed);
+            out.consumer_cache_hits      = cache_hits.load(std::memory_order_relaxed);
+            out.consumer_cache_refreshes = cache_refreshes.load(std::memory_order_relaxed);
+        }
+    };
+};
+
+/*
+Slot stamps:
+    - a policy can also ask the queue for a side array with one entry per slot by defining slot_stamps<capacity>
+    - the queue then calls producer_counters::on_slot_written(stamps, slot) after a slot is filled and
+      consumer_counters::on_slot_read(stamps, slot) after it is copied out, both before the index release, so the side
+      array is ordered by the queue indices just like the slots (see spsc_sojourn.h)
+    - policies without it get an empty member and no calls
+*/
+struct spsc_no_slot_stamps {};
+
+template <class Policy, std::size_t capacity, class = void>
+struct spsc_slot_stamps {
+    static constexpr bool enabled = false;
+    using type = spsc_no_slot_stamps;
+};
+
+template <class Policy, std::size_t capacity>
+struct spsc_slot_stamps<Policy, capacity, std::void_t<typename Policy::template slot_stamps<capacity>>> {
+    static constexpr bool enabled = true;
+    using type = typename Policy::template slot_stamps<capacity>;
+};
+
+};
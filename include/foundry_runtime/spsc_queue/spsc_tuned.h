@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_stats.h>
+
+namespace foundry_runtime {
+
+// one row of the tuning table, covers every message up to max_message_size bytes
+struct spsc_tuning {
+    std::size_t max_message_size;
+    std::size_t capacity;
+    bool        enable_cacheline_padding;
+    bool        enable_prefetch;
+};
+
+};
+
+/*
+Tuned Configurations:
+    - tools/spsc_autotune runs every padding/prefetch/capacity variant on the target box and core pair, and writes
+      foundry_runtime/spsc_queue/spsc_tuned_config.h with the winner per message size
+    - put the generated header on the include path of the deployment build and spsc_tuned_queue picks it up,
+      without it we fall back to the defaults below (padded, no prefetch, 1024 slots: what the benchmarks mostly favour)
+    - the table is sorted by max_message_size, a message bigger than the last row uses the last row
+*/
+#if defined(__has_include)
+    #if __has_include(<foundry_runtime/spsc_queue/spsc_tuned_config.h>)
+        #include <foundry_runtime/spsc_queue/spsc_tuned_config.h>
+        #define FOUNDRY_SPSC_TUNED_CONFIG
+    #endif
+#endif
+
+namespace foundry_runtime {
+
+#if !defined(FOUNDRY_SPSC_TUNED_CONFIG)
+namespace spsc_tuned_generated {
+    inline constexpr bool        measured = false;
+    inline constexpr const char* host     = "defaults";
+
+    inline constexpr spsc_tuning table[] = {
+        {64,   1024, true, false},
+        {1024, 1024, true, false},
+    };
+};
+#endif
+
+// the first row that fits message_size, else the last
+static constexpr spsc_tuning spsc_tuning_for(std::size_t message_size) noexcept {
+    constexpr std::size_t rows = sizeof(spsc_tuned_generated::table) / sizeof(spsc_tuning);
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (message_size <= spsc_tuned_generated::table[i].max_message_size) return spsc_tuned_generated::table[i];
+    }
+    return spsc_tuned_generated::table[rows - 1];
+}
+
+template <class T, class stats_policy = spsc_no_stats>
+using spsc_tuned_queue = spsc_queue<
+    T,
+    spsc_tuning_for(sizeof(T)).capacity,
+    spsc_tuning_for(sizeof(T)).enable_cacheline_padding,
+    spsc_tuning_for(sizeof(T)).enable_prefetch,
+    stats_policy
+>;
+
+};
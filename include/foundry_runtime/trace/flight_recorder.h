@@ -0,0 +1,310 @@
+#pragma once
+
+#if !defined(__linux__) && !defined(__APPLE__)
+    #error "flight_recorder needs posix write/signal (linux or macos)"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <foundry_runtime/spsc_queue/spsc_overwrite_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_stats.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+namespace foundry_runtime {
+
+// chrome trace event phases
+enum class trace_phase : char { begin = 'B', end = 'E', instant = 'i', counter = 'C' };
+
+// 32 bytes, names must be string literals (or otherwise outlive the process), only the pointer is recorded
+struct trace_record {
+    std::uint64_t tsc;
+    const char*   name;
+    std::uint64_t arg;
+    std::uint32_t object; // low bits of the emitting object's address, tells two queues with the same event name apart
+    trace_phase   phase;
+};
+
+static_assert(sizeof(trace_record) == 32);
+
+/*
+Flight Recorder:
+    - always on tracing: every thread that records gets its own spsc_overwrite_queue of trace_records on first use
+        - the recording thread is the ring's only producer, it never blocks and never fails, the oldest records just go
+        - recording is a thread_local load, a read_tsc and one overwrite enqueue, a few ns and no shared writes
+    - rings are registered in a fixed table and never freed, so a thread that already exited still shows up in the dump
+      (threads past max_threads just don't record)
+    - dump(fd) is the rings' single consumer, guarded by a flag so two dumps never overlap, and it only uses write(2),
+      stack buffers and integer formatting, so it is safe to call from a signal handler
+        - a dump drains what it writes, the next dump starts where this one stopped
+    - output is Chrome trace event JSON, load it in chrome://tracing or ui.perfetto.dev, one tid per ring
+
+    hot path:    record(), trace_scope
+    any thread:  name_thread(), set_clock(), dump(), dump_to_file(), install_signal_handler()
+*/
+class flight_recorder {
+public:
+    static constexpr std::size_t ring_capacity = 4096;
+    static constexpr std::size_t max_threads   = 256;
+
+    using ring_type = spsc_overwrite_queue<trace_record, ring_capacity>;
+
+    static void record(const char* name, trace_phase phase, std::uint64_t arg = 0, const void* object = nullptr) noexcept {
+        ring_type* ring = this_thread_ring();
+        if (ring == nullptr) return;
+        ring->enqueue(trace_record{read_tsc(), name, arg, std::uint32_t(reinterpret_cast<std::uintptr_t>(object)), phase});
+    }
+
+    static void begin(const char* name, std::uint64_t arg = 0) noexcept { record(name, trace_phase::begin, arg); }
+    static void end(const char* name, std::uint64_t arg = 0) noexcept { record(name, trace_phase::end, arg); }
+    static void instant(const char* name, std::uint64_t arg = 0, const void* object = nullptr) noexcept { record(name, trace_phase::instant, arg, object); }
+
+    // shown as the thread's name in the viewer, name must outlive the process like event names
+    static void name_thread(const char* name) noexcept {
+        if (this_thread_ring() != nullptr) thread_names[thread_index].store(name, std::memory_order_release);
+    }
+
+    // timestamps are raw ticks until a calibrated clock is set
+    static void set_clock(const tsc_clock& clock) noexcept {
+        ns_per_tick_fixed.store(clock.ns_per_tick_fixed32(), std::memory_order_relaxed);
+    }
+
+    // async signal safe, false if another dump was already running
+    static bool dump(int fd) noexcept {
+        if (dumping.test_and_set(std::memory_order_acquire)) return false;
+
+        FdWriter out(fd);
+        const std::uint64_t pid = std::uint64_t(::getpid());
+        const std::uint64_t scale = ns_per_tick_fixed.load(std::memory_order_relaxed);
+
+        out.put("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        bool first = true;
+
+        for (std::size_t tid = 0; tid < max_threads; ++tid) {
+            ring_type* ring = rings[tid].load(std::memory_order_acquire);
+            if (ring == nullptr) continue;
+
+            if (const char* thread_name = thread_names[tid].load(std::memory_order_acquire)) {
+                out.put(first ? "" : ",\n");
+                first = false;
+                out.put("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"); out.put_uint(pid);
+                out.put(",\"tid\":"); out.put_uint(tid);
+                out.put(",\"args\":{\"name\":\""); out.put_escaped(thread_name); out.put("\"}}");
+            }
+
+            trace_record event;
+            while (ring->try_dequeue(event)) {
+                out.put(first ? "" : ",\n");
+                first = false;
+
+                const char phase[2] = {char(event.phase), '\0'};
+                out.put("{\"name\":\""); out.put_escaped(event.name);
+                out.put("\",\"ph\":\""); out.put(phase);
+                out.put("\",\"pid\":"); out.put_uint(pid);
+                out.put(",\"tid\":"); out.put_uint(tid);
+                out.put(",\"ts\":"); out.put_micros(scale ? fixed32_multiply(event.tsc, scale) : event.tsc);
+                if (event.phase == trace_phase::instant) out.put(",\"s\":\"t\"");
+                out.put(",\"args\":{\"v\":"); out.put_uint(event.arg);
+                if (event.object) { out.put(",\"obj\":"); out.put_uint(event.object); }
+                out.put("}}");
+            }
+        }
+
+        out.put("\n]}\n");
+        out.flush();
+
+        dumping.clear(std::memory_order_release);
+        return true;
+    }
+
+    // not signal safe (open), for the on demand path
+    static bool dump_to_file(const char* path) noexcept {
+        const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        const bool written = dump(fd);
+        ::close(fd);
+        return written;
+    }
+
+    /*
+    Signal dump:
+        - the handler dumps straight to the fd given here (opened up front, since open isn't something to do in a handler)
+        - e.g. kill -USR2 <pid> on a live process that is showing a latency spike
+    */
+    static void install_signal_handler(int fd, int signal_number = SIGUSR2) noexcept {
+        signal_fd.store(fd, std::memory_order_relaxed);
+
+        struct sigaction action{};
+        action.sa_handler = [](int) {
+            const int saved_errno = errno; // the interrupted code may be about to look at errno
+            dump(signal_fd.load(std::memory_order_relaxed));
+            errno = saved_errno;
+        };
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        ::sigaction(signal_number, &action, nullptr);
+    }
+
+    // how many rings have been handed out (any thread)
+    static std::size_t threads_registered() noexcept { return next_index.load(std::memory_order_relaxed); }
+
+private:
+    static ring_type* this_thread_ring() noexcept {
+        if (thread_ring == nullptr && !thread_tried) register_this_thread();
+        return thread_ring;
+    }
+
+    static void register_this_thread() noexcept {
+        thread_tried = true;
+
+        const std::size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+        if (index >= max_threads) return;
+
+        ring_type* ring = new (std::nothrow) ring_type();
+        if (ring == nullptr) return;
+
+        thread_ring  = ring;
+        thread_index = index;
+        rings[index].store(ring, std::memory_order_release);
+    }
+
+    // buffered write(2) on the stack, nothing here allocates or locks
+    class FdWriter {
+    public:
+        explicit FdWriter(int out_fd) noexcept : fd(out_fd) {}
+
+        void put(const char* text) noexcept {
+            while (*text) {
+                if (used == sizeof(buffer)) flush();
+                buffer[used++] = *text++;
+            }
+        }
+
+        void put_escaped(const char* text) noexcept {
+            for (; *text; ++text) {
+                const char one[3] = {'\\', *text, '\0'};
+                put((*text == '"' || *text == '\\') ? one : one + 1);
+            }
+        }
+
+        void put_uint(std::uint64_t value) noexcept {
+            char digits[21];
+            std::size_t count = 0;
+            do {
+                digits[count++] = char('0' + value % 10);
+                value /= 10;
+            } while (value);
+
+            char text[21];
+            for (std::size_t i = 0; i < count; ++i) text[i] = digits[count - 1 - i];
+            text[count] = '\0';
+            put(text);
+        }
+
+        // chrome wants microseconds, keep the ns as three decimals
+        void put_micros(std::uint64_t ns) noexcept {
+            put_uint(ns / 1000);
+            const std::uint64_t fraction = ns % 1000;
+            const char text[5] = {'.', char('0' + fraction / 100), char('0' + fraction / 10 % 10), char('0' + fraction % 10), '\0'};
+            put(text);
+        }
+
+        void flush() noexcept {
+            std::size_t done = 0;
+            while (done < used) {
+                const ssize_t written = ::write(fd, buffer + done, used - done);
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) break;
+                done += std::size_t(written);
+            }
+            used = 0;
+        }
+
+    private:
+        int         fd;
+        std::size_t used = 0;
+        char        buffer[4096];
+    };
+
+    inline static std::atomic<ring_type*>  rings[max_threads]{};
+    inline static std::atomic<const char*> thread_names[max_threads]{};
+    inline static std::atomic<std::size_t> next_index{0};
+
+    inline static std::atomic<std::uint64_t> ns_per_tick_fixed{0}; // ns per tick in 32.32 fixed point, 0 = not calibrated
+    inline static std::atomic<int>           signal_fd{STDERR_FILENO};
+    inline static std::atomic_flag           dumping = ATOMIC_FLAG_INIT;
+
+    inline static thread_local ring_type*  thread_ring  = nullptr;
+    inline static thread_local std::size_t thread_index = 0;
+    inline static thread_local bool        thread_tried = false;
+};
+
+/*
+Trace Scope:
+    - RAII begin/end pair for a pipeline stage (or any block worth seeing on the timeline)
+    - name must be a string literal, arg is attached to the begin event (batch size, message id...)
+*/
+class trace_scope {
+public:
+    explicit trace_scope(const char* scope_name, std::uint64_t arg = 0) noexcept : name(scope_name) { flight_recorder::begin(name, arg); }
+
+    trace_scope(const trace_scope&)            = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+    ~trace_scope() { flight_recorder::end(name); }
+
+private:
+    const char* name;
+};
+
+/*
+Tracing stats policy:
+    - plugs the flight recorder into spsc_queue (and spsc_bqueue) through the existing stats_policy parameter
+    - enqueue/dequeue are recorded as instants (arg = producer side occupancy for enqueue)
+    - full/empty are only recorded on the transition into that state, a consumer spinning on an empty queue would
+      otherwise flood its ring and push out the history worth looking at
+    - the counters structs hold one bool each, so spsc_stats_snapshot stays all zeros with this policy
+*/
+struct spsc_trace_stats {
+    struct producer_counters {
+        bool was_full = false;
+
+        void on_full() noexcept {
+            if (!was_full) flight_recorder::instant("spsc.full", 0, this);
+            was_full = true;
+        }
+        void on_cache_hit()     noexcept {}
+        void on_cache_refresh() noexcept {}
+        void on_enqueue(std::size_t occupancy) noexcept {
+            was_full = false;
+            flight_recorder::instant("spsc.enqueue", occupancy, this);
+        }
+        void snapshot_into(spsc_stats_snapshot&) const noexcept {}
+    };
+
+    struct consumer_counters {
+        bool was_empty = false;
+
+        void on_empty() noexcept {
+            if (!was_empty) flight_recorder::instant("spsc.empty", 0, this);
+            was_empty = true;
+        }
+        void on_cache_hit()     noexcept {}
+        void on_cache_refresh() noexcept {}
+        void on_dequeue() noexcept {
+            was_empty = false;
+            flight_recorder::instant("spsc.dequeue", 0, this);
+        }
+        void snapshot_into(spsc_stats_snapshot&) const noexcept {}
+    };
+};
+
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+Runtime trace hooks:
+    - park/wake style events inside the runtime's own primitives (eventfd channel, rpc futex waits)
+    - compiled in only with FOUNDRY_TRACE_RUNTIME_EVENTS defined, so code that never looks at traces doesn't pay for
+      (or register) a flight recorder ring on those paths
+    - queues are traced through spsc_trace_stats instead, that is already a per queue choice
+*/
+#if defined(FOUNDRY_TRACE_RUNTIME_EVENTS)
+    #include <foundry_runtime/trace/flight_recorder.h>
+    #define FOUNDRY_TRACE_RUNTIME(name, arg, object) ::foundry_runtime::flight_recorder::instant(name, arg, object)
+#else
+    #define FOUNDRY_TRACE_RUNTIME(name, arg, object) ((void)0)
+#endif
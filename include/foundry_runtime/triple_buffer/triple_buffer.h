@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include <foundry_runtime/hardware/hardware.h>
+
+namespace foundry_runtime {
+
+/*
+Triple Buffer:
+    - for handing big state blocks (tens of KB) from one writer thread to one reader thread with zero copies
+    - three buffers, the writer owns back, the reader owns front, and middle is whatever was last published
+    - the only shared word is middle's index (plus a dirty bit), every handoff is a single atomic exchange on it
+        - publish(): swap back into middle with the dirty bit set, whatever was in middle becomes the new back
+        - latest():  if middle is dirty, swap front into middle, whatever was published becomes the new front
+    - neither side ever waits, the writer can publish as often as it likes and the reader just sees the newest block
+
+NOTE: acquire_back() hands back a recycled buffer holding stale (older) state, the writer has to fully rewrite it
+*/
+template <class T>
+class triple_buffer {
+    static_assert(std::is_default_constructible_v<T>, "T must be default constructible...");
+
+    static constexpr std::uint8_t index_mask = 0b011;
+    static constexpr std::uint8_t dirty_bit  = 0b100;
+
+    // each buffer starts on its own line so the writer filling back never shares a line with the reader's front
+    struct alignas(cacheline_size) PaddedBuffer {
+        T value{};
+    };
+
+    struct alignas(cacheline_size) PaddedMiddle {
+        std::atomic<std::uint8_t> index{1};
+    };
+
+    struct alignas(cacheline_size) WriterSide {
+        std::uint8_t back = 0;
+    };
+
+    struct alignas(cacheline_size) ReaderSide {
+        std::uint8_t front = 2;
+    };
+
+    static_assert(std::atomic<std::uint8_t>::is_always_lock_free);
+
+public:
+    triple_buffer()                                = default;
+    triple_buffer(const triple_buffer&)            = delete;
+    triple_buffer& operator=(const triple_buffer&) = delete;
+
+    ~triple_buffer() = default;
+
+    // writer side
+    T& acquire_back() noexcept { return buffers[writer.back].value; }
+
+    void publish() noexcept {
+        // release publishes our writes to back, acquire makes the reader's last reads of the buffer we get back happen before our rewrite
+        writer.back = middle.index.exchange(std::uint8_t(writer.back | dirty_bit), std::memory_order_acq_rel) & index_mask;
+    }
+
+    // reader side
+    const T& latest() noexcept {
+        if (middle.index.load(std::memory_order_relaxed) & dirty_bit) {
+            reader.front = middle.index.exchange(reader.front, std::memory_order_acq_rel) & index_mask;
+        }
+        return buffers[reader.front].value;
+    }
+
+    bool has_update() const noexcept { return middle.index.load(std::memory_order_relaxed) & dirty_bit; }
+
+private:
+    PaddedMiddle middle{};
+    WriterSide   writer{};
+    ReaderSide   reader{};
+
+    PaddedBuffer buffers[3];
+};
+
+};
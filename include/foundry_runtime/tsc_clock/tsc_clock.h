@@ -0,0 +1,184 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+    #include <x86intrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <time.h>
+#endif
+
+namespace foundry_runtime {
+
+// cheapest stamp, can be reordered with the surrounding loads/stores (fine for start stamps and tracing)
+static inline std::uint64_t read_tsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks)); // generic timer, constant rate on aarch64
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// waits for every earlier instruction to finish before reading (rdtscp / isb), use it for the stamp that ends an interval
+static inline std::uint64_t read_tsc_ordered() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int aux;
+    return __rdtscp(&aux);
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) :: "memory");
+    return ticks;
+#else
+    return read_tsc();
+#endif
+}
+
+/*
+Invariant TSC:
+    - x86: cpuid 0x80000007 edx bit 8, the tsc then ticks at a constant rate through p/c states and is synced across cores
+    - without it the ticks per ns can drift with frequency changes, stamps still order but conversions go stale
+    - aarch64's generic timer is constant rate by spec, the steady_clock fallback is nanoseconds already
+*/
+static inline bool tsc_is_invariant() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+    return (edx & (1u << 8)) != 0;
+#else
+    return true;
+#endif
+}
+
+// CLOCK_MONOTONIC in ns, the reference the tsc is calibrated against
+static inline std::uint64_t monotonic_ns() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return std::uint64_t(now.tv_sec) * 1'000'000'000ull + std::uint64_t(now.tv_nsec);
+#else
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/*
+32.32 fixed point multiply:
+    - (value * factor) >> 32 without losing the high bits, the one multiply + shift behind every tick -> ns conversion
+    - a 128 bit multiply where the compiler has one, otherwise four 32x32 partial products (exact, just slower)
+*/
+static inline std::uint64_t fixed32_multiply(std::uint64_t value, std::uint64_t factor) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    return std::uint64_t(uint128(value) * factor >> 32);
+#else
+    const std::uint64_t value_high  = value >> 32,  value_low  = value & 0xffffffffu;
+    const std::uint64_t factor_high = factor >> 32, factor_low = factor & 0xffffffffu;
+    return ((value_high * factor_high) << 32) + value_high * factor_low + value_low * factor_high + ((value_low * factor_low) >> 32);
+#endif
+}
+
+/*
+TSC Clock:
+    - a plain trivially copyable value, copy it into every thread that converts (or hand new ones out through a
+      conflating_channel after a recalibrate), nothing in here is shared or atomic
+    - to_ns() is the double conversion, ticks_to_ns() the integer one: ns_per_tick in 32.32 fixed point, one multiply
+      and a shift, no divide and no floating point on the hot path
+    - now_ns() lands in the CLOCK_MONOTONIC domain, so tsc stamps can be lined up with timestamps from other sources
+        - it never steps backwards on one copy, recalibrate() re-anchors where the old conversion had got to (or at the
+          current CLOCK_MONOTONIC if that is later), so it can run ahead of CLOCK_MONOTONIC by at most the drift the
+          recalibration just corrected
+*/
+class tsc_clock {
+public:
+    /*
+    Calibration:
+        1. take a (CLOCK_MONOTONIC, tsc) anchor pair, sleep for the window, take another pair
+        2. each pair brackets clock_gettime between two tsc reads and keeps the tightest of a few tries, so a
+           preemption in the middle doesn't skew the pair
+        3. the ratio of the tsc delta to the monotonic delta is our ticks per ns
+        4. recalibrate() later measures the ratio against the same first pair (origin), so the baseline (and accuracy)
+           keeps growing, while now_ns() is re-anchored at the latest pair
+    */
+    static tsc_clock calibrate(std::chrono::nanoseconds window = std::chrono::milliseconds(10)) {
+        const Anchor start = sample_anchor();
+        std::this_thread::sleep_for(window);
+        const Anchor end = sample_anchor();
+
+        return tsc_clock(start, end, tsc_is_invariant());
+    }
+
+    // call periodically (e.g. once a second from a housekeeping loop) on the thread that owns this copy
+    // (no cpuid in here, it traps to the hypervisor in a vm, the invariant flag is carried over from calibrate)
+    void recalibrate() noexcept {
+        const Anchor current = sample_anchor();
+        const std::uint64_t continued = anchor.ns + ticks_to_ns(current.tsc - anchor.tsc); // where now_ns() had got to
+
+        *this  = tsc_clock(origin, current, invariant_);
+        anchor = Anchor{current.ns > continued ? current.ns : continued, current.tsc};
+    }
+
+    double ticks_per_ns() const noexcept { return ticks_per_ns_; }
+
+    double to_ns(std::uint64_t ticks) const noexcept { return double(ticks) * ns_per_tick_; }
+
+    std::uint64_t ticks_to_ns(std::uint64_t ticks) const noexcept {
+        return fixed32_multiply(ticks, ns_per_tick_fixed_);
+    }
+
+    std::uint64_t ns_to_ticks(std::uint64_t ns) const noexcept { return std::uint64_t(double(ns) * ticks_per_ns_); }
+
+    std::uint64_t now_ns() const noexcept { return anchor.ns + ticks_to_ns(read_tsc() - anchor.tsc); }
+
+    // ns per tick in 32.32 fixed point, for code that wants to carry the conversion around as one integer
+    std::uint64_t ns_per_tick_fixed32() const noexcept { return ns_per_tick_fixed_; }
+
+    bool invariant() const noexcept { return invariant_; }
+
+private:
+    struct Anchor {
+        std::uint64_t ns;
+        std::uint64_t tsc;
+    };
+
+    static Anchor sample_anchor() noexcept {
+        Anchor best{0, 0};
+        std::uint64_t best_window = ~std::uint64_t(0);
+
+        for (int attempt = 0; attempt < 5; ++attempt) {
+            const std::uint64_t before = read_tsc_ordered();
+            const std::uint64_t ns     = monotonic_ns();
+            const std::uint64_t after  = read_tsc_ordered();
+
+            if (after - before < best_window) {
+                best_window = after - before;
+                best = Anchor{ns, before + (after - before) / 2};
+            }
+        }
+        return best;
+    }
+
+    tsc_clock(Anchor start, Anchor end, bool invariant) noexcept
+        : origin(start),
+          anchor(start),
+          ticks_per_ns_(double(end.tsc - start.tsc) / double(end.ns - start.ns)),
+          ns_per_tick_(1.0 / ticks_per_ns_),
+          ns_per_tick_fixed_(std::uint64_t(ns_per_tick_ * 4294967296.0 + 0.5)),
+          invariant_(invariant) {}
+
+    Anchor        origin; // first calibration pair, the ratio is always measured from here
+    Anchor        anchor; // now_ns() counts from here
+    double        ticks_per_ns_;
+    double        ns_per_tick_;
+    std::uint64_t ns_per_tick_fixed_;
+    bool          invariant_;
+};
+
+};
@@ -0,0 +1,254 @@
+#include <foundry_runtime/spsc_queue/spsc_queue.h>
+#include <foundry_runtime/spsc_queue/spsc_tuned.h>
+#include <foundry_runtime/tsc_clock/tsc_clock.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+#include <unistd.h>
+
+
+
+/*
+SPSC Autotune:
+    - usage: spsc_autotune [output header] [producer cpu] [consumer cpu] [repeats] [mib per run]
+    - for every message size below, runs every (capacity, padding, prefetch) variant of spsc_queue with the producer and
+      consumer pinned to the given cpus, `repeats` times each, and scores a variant by its median ns/op
+    - the winner per message size is the smallest queue within `tolerance` of the fastest one, a bigger ring that is
+      only faster by noise isn't worth its cache footprint
+    - writes foundry_runtime/spsc_queue/spsc_tuned_config.h style output (see spsc_tuned.h), so build the deployment
+      with the output's directory on the include path:
+          spsc_autotune tuned/foundry_runtime/spsc_queue/spsc_tuned_config.h 2 3  =>  -Ituned
+    - run it on the target box, idle, on the core pair the real producer/consumer will use (siblings, same socket,
+      across sockets all give different answers, which is the point)
+*/
+constexpr std::size_t message_sizes[] = {8, 64, 256, 1024};
+constexpr double      tolerance       = 0.03;
+
+template <std::size_t size>
+struct Message {
+    static_assert(size % 8 == 0);
+    std::uint64_t words[size / 8];
+};
+
+struct Variant {
+    std::size_t message_size;
+    std::size_t capacity;
+    bool        padding;
+    bool        prefetch;
+    std::size_t footprint;
+    double      ns_per_op;
+};
+
+struct Settings {
+    int           producer_cpu;
+    int           consumer_cpu;
+    int           repeats;
+    std::uint64_t bytes_per_run;
+    bool          spin; // cpu_relax while waiting, only when the two sides really run side by side
+};
+
+void pinToCpu(int cpu) {
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) std::cerr << "could not pin to cpu " << cpu << ", running unpinned\n";
+#else
+    (void)cpu;
+#endif
+}
+
+void waitOnce(bool spin) {
+    if (spin) foundry_runtime::cpu_relax();
+    else std::this_thread::yield();
+}
+
+/*
+One Run:
+    - fresh queue per run (make_unique value initializes, so the slots are paged in before the clock starts)
+    - the consumer checks the sequence word, a variant that loses or reorders messages is a bug, not a result
+*/
+template <class QueueType>
+double runOnce(std::uint64_t number, const Settings& settings, const foundry_runtime::tsc_clock& clock) {
+    using MessageType = typename QueueType::value_type;
+    auto queue = std::make_unique<QueueType>();
+
+    bool in_order = true;
+    std::thread consumer([&] {
+        pinToCpu(settings.consumer_cpu);
+        MessageType message;
+        for (std::uint64_t expected = 0; expected < number;) {
+            if (!queue->try_dequeue(message)) {
+                waitOnce(settings.spin);
+                continue;
+            }
+            in_order &= message.words[0] == expected++;
+        }
+    });
+
+    std::uint64_t start = 0;
+    std::thread producer([&] {
+        pinToCpu(settings.producer_cpu);
+        MessageType message{};
+        start = foundry_runtime::read_tsc();
+        for (std::uint64_t i = 0; i < number; ++i) {
+            message.words[0] = i;
+            while (!queue->try_enqueue(message)) waitOnce(settings.spin);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    const std::uint64_t end = foundry_runtime::read_tsc_ordered();
+
+    if (!in_order) {
+        std::cerr << "messages arrived out of order, aborting\n";
+        std::exit(1);
+    }
+    return clock.to_ns(end - start) / double(number);
+}
+
+template <std::size_t message_size, std::size_t capacity, bool padding, bool prefetch>
+void measure(std::vector<Variant>& results, const Settings& settings, const foundry_runtime::tsc_clock& clock) {
+    using QueueType = foundry_runtime::spsc_queue<Message<message_size>, capacity, padding, prefetch>;
+
+    const std::uint64_t number = std::clamp<std::uint64_t>(settings.bytes_per_run / message_size, 100'000, 4'000'000);
+
+    std::vector<double> runs;
+    for (int repeat = 0; repeat < settings.repeats; ++repeat) runs.push_back(runOnce<QueueType>(number, settings, clock));
+    std::sort(runs.begin(), runs.end());
+
+    const Variant variant{message_size, capacity, padding, prefetch, sizeof(QueueType), runs[runs.size() / 2]};
+    results.push_back(variant);
+
+    std::cout << "size=" << message_size << " capacity=" << capacity << " padding=" << padding << " prefetch=" << prefetch
+              << " footprint=" << variant.footprint << " ns/op=" << variant.ns_per_op << "\n";
+}
+
+template <std::size_t message_size, std::size_t capacity>
+void measureCapacity(std::vector<Variant>& results, const Settings& settings, const foundry_runtime::tsc_clock& clock) {
+    measure<message_size, capacity, false, false>(results, settings, clock);
+    measure<message_size, capacity, false, true >(results, settings, clock);
+    measure<message_size, capacity, true,  false>(results, settings, clock);
+    measure<message_size, capacity, true,  true >(results, settings, clock);
+}
+
+template <std::size_t message_size>
+void measureSize(std::vector<Variant>& results, const Settings& settings, const foundry_runtime::tsc_clock& clock) {
+    measureCapacity<message_size, 256  >(results, settings, clock);
+    measureCapacity<message_size, 1024 >(results, settings, clock);
+    measureCapacity<message_size, 4096 >(results, settings, clock);
+    measureCapacity<message_size, 16384>(results, settings, clock);
+}
+
+Variant pickWinner(const std::vector<Variant>& results, std::size_t message_size) {
+    double fastest = 1e300;
+    for (const auto& variant : results) {
+        if (variant.message_size == message_size) fastest = std::min(fastest, variant.ns_per_op);
+    }
+
+    const Variant* winner = nullptr;
+    for (const auto& variant : results) {
+        if (variant.message_size != message_size || variant.ns_per_op > fastest * (1.0 + tolerance)) continue;
+        if (winner == nullptr || variant.footprint < winner->footprint
+            || (variant.footprint == winner->footprint && variant.ns_per_op < winner->ns_per_op)) winner = &variant;
+    }
+    return *winner;
+}
+
+std::string hostName() {
+    char name[256] = {};
+    if (::gethostname(name, sizeof(name) - 1) != 0) return "unknown";
+
+    std::string safe;
+    for (const char* c = name; *c; ++c) safe += (*c == '"' || *c == '\\') ? '_' : *c;
+    return safe;
+}
+
+bool writeHeader(const char* path, const std::vector<Variant>& winners, const Settings& settings) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    const std::time_t now = std::time(nullptr);
+    char when[32];
+    std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+
+    out << "#pragma once\n\n"
+        << "// generated by tools/spsc_autotune, do not edit, rerun it instead (included by spsc_tuned.h, not on its own)\n"
+        << "// host " << hostName() << ", producer cpu " << settings.producer_cpu << ", consumer cpu " << settings.consumer_cpu
+        << ", " << settings.repeats << " runs per variant, " << when << "\n\n"
+        << "namespace foundry_runtime {\n\n"
+        << "namespace spsc_tuned_generated {\n"
+        << "    inline constexpr bool        measured = true;\n"
+        << "    inline constexpr const char* host     = \"" << hostName() << "\";\n\n"
+        << "    inline constexpr spsc_tuning table[] = {\n";
+
+    for (const auto& winner : winners) {
+        out << "        {" << std::setw(4) << winner.message_size << ", " << std::setw(5) << winner.capacity << ", "
+            << (winner.padding ? "true,  " : "false, ") << (winner.prefetch ? "true " : "false") << "}, "
+            << "// " << winner.ns_per_op << " ns/op\n";
+    }
+
+    out << "    };\n"
+        << "};\n\n"
+        << "};\n";
+    return bool(out);
+}
+
+int main(int argc, char** argv) {
+    const char* output = argc > 1 ? argv[1] : "spsc_tuned_config.h";
+
+    const int hardware_threads = int(std::max(1u, std::thread::hardware_concurrency()));
+
+    Settings settings;
+    settings.producer_cpu  = argc > 2 ? std::atoi(argv[2]) : 0;
+    settings.consumer_cpu  = argc > 3 ? std::atoi(argv[3]) : (hardware_threads > 1 ? 1 : 0);
+    settings.repeats       = argc > 4 ? std::max(1, std::atoi(argv[4])) : 5;
+    settings.bytes_per_run = (argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 16) << 20;
+    settings.spin          = settings.producer_cpu != settings.consumer_cpu && hardware_threads > 1;
+
+    if (settings.producer_cpu >= hardware_threads || settings.consumer_cpu >= hardware_threads) {
+        std::cerr << "cpu out of range, this box has " << hardware_threads << " hardware threads\n";
+        return 1;
+    }
+
+    const auto clock = foundry_runtime::tsc_clock::calibrate(std::chrono::milliseconds(50));
+    std::cout << "Producer cpu=" << settings.producer_cpu << " Consumer cpu=" << settings.consumer_cpu
+              << " Wait=" << (settings.spin ? "spin" : "yield") << " Invariant TSC=" << clock.invariant() << "\n";
+    if (!settings.spin) std::cout << "Note=both sides share a cpu, results reflect time slicing rather than cache traffic\n";
+
+    std::vector<Variant> results;
+    measureSize<8   >(results, settings, clock);
+    measureSize<64  >(results, settings, clock);
+    measureSize<256 >(results, settings, clock);
+    measureSize<1024>(results, settings, clock);
+
+    std::vector<Variant> winners;
+    for (const std::size_t message_size : message_sizes) {
+        winners.push_back(pickWinner(results, message_size));
+        const auto& winner = winners.back();
+        std::cout << "Winner size=" << winner.message_size << " capacity=" << winner.capacity << " padding=" << winner.padding
+                  << " prefetch=" << winner.prefetch << " ns/op=" << winner.ns_per_op << "\n";
+    }
+
+    if (!writeHeader(output, winners, settings)) {
+        std::cerr << "could not write " << output << "\n";
+        return 1;
+    }
+    std::cout << "Wrote=" << output << "\n";
+    return 0;
+}